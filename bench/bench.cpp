@@ -0,0 +1,217 @@
+// headless benchmark for the workspace mapping logic in src/split.cpp
+// drives it against an in-memory mock compositor, so it runs without a wayland session or gpu
+
+#include "../src/split.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static std::atomic<size_t> g_allocations = 0;
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+struct SBenchConfig {
+    size_t monitors      = 8;
+    long   numWorkspaces = 50;
+    size_t windows       = 2000;
+    size_t iterations    = 100000;
+};
+
+// mirrors what the plugin keeps in main.cpp, with plain data instead of hyprland objects
+class CMockCompositor {
+  public:
+    CMockCompositor(const SBenchConfig& config) : m_numWorkspaces(config.numWorkspaces), m_rng(1337) {
+        for (size_t i = 0; i < config.monitors; i++) {
+            m_monitors.emplace_back(SMonitorDesc{.id = (long)i, .name = "DP-" + std::to_string(config.monitors - i)});
+        }
+        // a few monitors with monitor_priority entries, the rest sorted by name
+        for (size_t i = 0; i < m_monitors.size() / 2; i++) {
+            m_monitors[i].priority = i;
+        }
+        m_numPriorities = m_monitors.size() / 2;
+        rebuildRanges();
+
+        for (const auto& m : m_monitors) {
+            const auto RANGE = MonitorRange(m.base, m_numWorkspaces);
+            m_active.push_back(RANGE.min);
+            for (long id = RANGE.min; id <= RANGE.max; id++) {
+                sortedInsert(m_occupancy.live, id);
+            }
+        }
+
+        for (size_t i = 0; i < config.windows; i++) {
+            m_windowWorkspace.push_back(0);
+            moveWindow(i, randomWorkspace());
+        }
+    }
+
+    void rebuildRanges() {
+        assignMonitorBases(m_monitors, true, m_numPriorities);
+    }
+
+    long randomWorkspace() {
+        const auto& MONITOR = m_monitors[m_rng() % m_monitors.size()];
+        const auto  RANGE   = MonitorRange(MONITOR.base, m_numWorkspaces);
+        // leave the top of every range empty so "empty" has something to find
+        return RANGE.min + (long)(m_rng() % (m_numWorkspaces - m_numWorkspaces / 4));
+    }
+
+    // same bookkeeping as indexAddWindow / indexRemoveWindow in the plugin
+    void moveWindow(size_t window, long workspace) {
+        const long OLD = m_windowWorkspace[window];
+        if (OLD != 0) {
+            auto& count = m_windowCount[OLD];
+            if (--count == 0)
+                sortedErase(m_occupancy.occupied, OLD);
+        }
+
+        m_windowWorkspace[window] = workspace;
+        if (m_windowCount[workspace]++ == 0)
+            sortedInsert(m_occupancy.occupied, workspace);
+    }
+
+    // split:workspace on the given monitor, the result becomes the active workspace
+    void dispatch(size_t monitor, const std::string& arg) {
+        const auto& MONITOR = m_monitors[monitor];
+        const auto  RESULT  = resolveWorkspaceArg(getCachedWorkspaceArg(m_argCache, arg), MonitorRange(MONITOR.base, m_numWorkspaces), m_active[monitor], m_occupancy);
+        if (RESULT.has_value())
+            m_active[monitor] = RESULT.value();
+    }
+
+    SRulePlan reconcile() {
+        std::vector<std::pair<MonitorRange, std::string>> desired;
+        for (const auto& m : m_monitors) {
+            desired.emplace_back(MonitorRange(m.base, m_numWorkspaces), m.name);
+        }
+
+        return planPersistentRules(m_rules, desired);
+    }
+
+    void applyPlan(const SRulePlan& plan) {
+        for (const auto& [INDEX, MONITOR] : plan.update) {
+            m_rules[INDEX].monitor = MONITOR;
+        }
+        for (auto it = plan.remove.rbegin(); it != plan.remove.rend(); it++) {
+            m_rules.erase(m_rules.begin() + *it);
+        }
+        m_rules.insert(m_rules.end(), plan.add.begin(), plan.add.end());
+    }
+
+    std::vector<SMonitorDesc>        m_monitors;
+    std::vector<long>                m_active;
+    std::vector<long>                m_windowWorkspace;
+    std::unordered_map<long, size_t> m_windowCount;
+    std::vector<SPersistentRule>     m_rules;
+    SOccupancy                       m_occupancy;
+    CWorkspaceArgCache               m_argCache;
+    long                             m_numWorkspaces = 10;
+    size_t                           m_numPriorities = 0;
+    std::mt19937                     m_rng;
+};
+
+static void run(const char* name, size_t iterations, const std::function<void(size_t)>& fn) {
+    // warm up caches, including the parsed arg cache
+    for (size_t i = 0; i < std::min<size_t>(iterations, 1000); i++) {
+        fn(i);
+    }
+
+    const size_t ALLOCSBEFORE = g_allocations.load();
+    const auto   BEGIN        = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+
+    const auto   END    = std::chrono::steady_clock::now();
+    const size_t ALLOCS = g_allocations.load() - ALLOCSBEFORE;
+    const double NS     = std::chrono::duration<double, std::nano>(END - BEGIN).count();
+
+    std::printf("%-28s %12.1f ns/op %10.3f allocs/op\n", name, NS / iterations, (double)ALLOCS / iterations);
+}
+
+int main(int argc, char** argv) {
+    SBenchConfig config;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const auto VALUE = std::strtol(argv[i + 1], nullptr, 10);
+        if (!std::strcmp(argv[i], "--monitors"))
+            config.monitors = VALUE;
+        else if (!std::strcmp(argv[i], "--workspaces"))
+            config.numWorkspaces = VALUE;
+        else if (!std::strcmp(argv[i], "--windows"))
+            config.windows = VALUE;
+        else if (!std::strcmp(argv[i], "--iterations"))
+            config.iterations = VALUE;
+        else {
+            std::fprintf(stderr, "usage: %s [--monitors N] [--workspaces N] [--windows N] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.monitors < 1 || config.numWorkspaces < 4 || config.windows < 1 || config.iterations < 100) {
+        std::fprintf(stderr, "need at least 1 monitor, 4 workspaces, 1 window and 100 iterations\n");
+        return 1;
+    }
+
+    std::printf("%zu monitors x %ld workspaces x %zu windows, %zu iterations\n", config.monitors, config.numWorkspaces, config.windows, config.iterations);
+
+    CMockCompositor mock(config);
+    const size_t    M = config.monitors;
+
+    run("split:workspace 3", config.iterations, [&](size_t i) { mock.dispatch(i % M, "3"); });
+    run("split:workspace +1", config.iterations, [&](size_t i) { mock.dispatch(i % M, "+1"); });
+    run("split:workspace r+1", config.iterations, [&](size_t i) { mock.dispatch(i % M, "r+1"); });
+    run("split:workspace e+1", config.iterations, [&](size_t i) { mock.dispatch(i % M, "e+1"); });
+    run("split:workspace m-1", config.iterations, [&](size_t i) { mock.dispatch(i % M, "m-1"); });
+    run("split:workspace empty", config.iterations, [&](size_t i) { mock.dispatch(i % M, "empty"); });
+    run("window move", config.iterations, [&](size_t i) { mock.moveWindow(i % config.windows, mock.randomWorkspace()); });
+    run("range table rebuild", config.iterations / 10, [&](size_t) { mock.rebuildRanges(); });
+
+    // monitor_workspaces style layout, alternating big and small monitors
+    SRangeLayout      layout;
+    std::vector<long> counts;
+    for (size_t i = 0; i < M; i++) {
+        counts.push_back(i % 2 ? config.numWorkspaces / 4 : config.numWorkspaces);
+    }
+    buildRangeLayout(layout, counts, config.numWorkspaces);
+    const long LASTID = layout.starts.back();
+
+    long       sink = 0;
+    run("workspace -> monitor lookup", config.iterations, [&](size_t i) { sink += baseForWorkspaceID(layout, 1 + (long)((i * 7919) % LASTID)); });
+    if (sink < 0)
+        std::printf("unreachable\n");
+
+    SWorkspaceHistory history;
+    const auto        RANGE0 = MonitorRange(mock.m_monitors[0].base, config.numWorkspaces);
+    run("split:workspace previous", config.iterations, [&](size_t i) {
+        history.push(RANGE0.min + (long)(i % 3));
+        sink += history.previous(RANGE0.min + (long)(i % 3), RANGE0).value_or(0);
+    });
+
+    mock.applyPlan(mock.reconcile());
+    run("persistent reconcile", config.iterations / 100, [&](size_t) { mock.reconcile(); });
+
+    return 0;
+}
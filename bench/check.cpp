@@ -0,0 +1,200 @@
+// correctness checks for the workspace mapping logic in src/split.cpp on known inputs, next to the benchmark of the same code
+
+#include "../src/split.hpp"
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+
+static int g_failures = 0;
+
+#define CHECK(expr)                                                                                                                                                                \
+    do {                                                                                                                                                                           \
+        if (!(expr)) {                                                                                                                                                             \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr);                                                                                        \
+            g_failures++;                                                                                                                                                          \
+        }                                                                                                                                                                          \
+    } while (0)
+
+static std::optional<long> resolve(const char* arg, const MonitorRange& range, long activeID, const SOccupancy& occupancy) {
+    return resolveWorkspaceArg(parseWorkspaceArg(arg), range, activeID, occupancy);
+}
+
+static void checkParse() {
+    CHECK(parseWorkspaceArg("3").kind == WSARG_ABSOLUTE && parseWorkspaceArg("3").value == 3);
+    CHECK(parseWorkspaceArg("-2").kind == WSARG_RELATIVE && parseWorkspaceArg("-2").value == -2);
+    CHECK(parseWorkspaceArg("r+1").kind == WSARG_RELATIVE_WRAP);
+    CHECK(parseWorkspaceArg("e-1").kind == WSARG_RELATIVE_OPEN && parseWorkspaceArg("e-1").value == -1);
+    CHECK(parseWorkspaceArg("m+2").kind == WSARG_RELATIVE_LOOP && parseWorkspaceArg("m+2").value == 2);
+    CHECK(parseWorkspaceArg("empty").kind == WSARG_EMPTY);
+    CHECK(parseWorkspaceArg("previous").kind == WSARG_PREVIOUS);
+    CHECK(parseWorkspaceArg("previous_per_monitor").kind == WSARG_PREVIOUS);
+    CHECK(parseWorkspaceArg("name:foo").kind == WSARG_PASSTHROUGH);
+    CHECK(parseWorkspaceArg("+x").kind == WSARG_PASSTHROUGH);
+    CHECK(parseWorkspaceArg("3a").kind == WSARG_PASSTHROUGH);
+
+    // the move dispatchers look up the workspace part of "workspace,window" without copying it
+    CWorkspaceArgCache cache;
+    const auto&        ARG = getCachedWorkspaceArg(cache, std::string_view{"r+1,class:foot"}.substr(0, 3));
+    CHECK(ARG.kind == WSARG_RELATIVE_WRAP && ARG.value == 1);
+    CHECK(&getCachedWorkspaceArg(cache, std::string{"r+1"}) == &ARG && cache.size() == 1);
+}
+
+static void checkResolve() {
+    const auto RANGE = MonitorRange(1, 10); // 11 - 20
+    SOccupancy occupancy;
+    occupancy.live     = {1, 11, 12, 14, 17, 21};
+    occupancy.occupied = {1, 11, 14, 17, 21};
+
+    CHECK(resolve("3", RANGE, 11, occupancy) == 13);
+    CHECK(resolve("13", RANGE, 11, occupancy) == 13); // wraps at the range size
+    CHECK(resolve("+1", RANGE, 11, occupancy) == 12);
+    CHECK(resolve("+15", RANGE, 11, occupancy) == 20); // no looping
+    CHECK(resolve("-1", RANGE, 11, occupancy) == 11);
+    CHECK(resolve("r+1", RANGE, 20, occupancy) == 11);
+    CHECK(resolve("r-1", RANGE, 11, occupancy) == 20);
+
+    // e: existing workspaces in the range only, clamped at the ends
+    CHECK(resolve("e+1", RANGE, 12, occupancy) == 14);
+    CHECK(resolve("e+5", RANGE, 12, occupancy) == 17);
+    CHECK(resolve("e-1", RANGE, 11, occupancy) == 11);
+
+    // m: occupied workspaces in the range with looping, including stepping off an empty active workspace
+    CHECK(resolve("m+1", RANGE, 14, occupancy) == 17);
+    CHECK(resolve("m+1", RANGE, 17, occupancy) == 11);
+    CHECK(resolve("m+1", RANGE, 12, occupancy) == 14);
+    CHECK(resolve("m-1", RANGE, 12, occupancy) == 11);
+    CHECK(resolve("m-1", RANGE, 15, occupancy) == 14);
+    CHECK(resolve("m+1", MonitorRange(3, 10), 35, occupancy) == 35); // nothing occupied
+
+    CHECK(resolve("empty", RANGE, 11, occupancy) == 12);
+    SOccupancy full;
+    for (long id = 11; id <= 20; id++) {
+        sortedInsert(full.occupied, id);
+    }
+    CHECK(resolve("empty", RANGE, 15, full) == 15);
+
+    CHECK(!resolve("name:foo", RANGE, 11, occupancy).has_value());
+    CHECK(!resolve("previous", RANGE, 11, occupancy).has_value());
+}
+
+static void checkLayout() {
+    SRangeLayout layout;
+    buildRangeLayout(layout, {20, 4, 4}, 10);
+
+    CHECK(rangeForBase(layout, 0).min == 1 && rangeForBase(layout, 0).max == 20);
+    CHECK(rangeForBase(layout, 1).min == 21 && rangeForBase(layout, 1).max == 24);
+    CHECK(rangeForBase(layout, 2).min == 25 && rangeForBase(layout, 2).max == 28);
+    CHECK(rangeForBase(layout, 3).min == 29 && rangeForBase(layout, 3).max == 38); // past the table, default count
+    CHECK(rangeForBase(layout, -1).size() == 0);
+
+    CHECK(baseForWorkspaceID(layout, 0) == -1);
+    CHECK(baseForWorkspaceID(layout, 1) == 0);
+    CHECK(baseForWorkspaceID(layout, 20) == 0);
+    CHECK(baseForWorkspaceID(layout, 21) == 1);
+    CHECK(baseForWorkspaceID(layout, 24) == 1);
+    CHECK(baseForWorkspaceID(layout, 25) == 2);
+    CHECK(baseForWorkspaceID(layout, 29) == 3);
+    CHECK(baseForWorkspaceID(layout, 39) == 4);
+
+    for (long id = 1; id <= 60; id++) {
+        CHECK(rangeForBase(layout, baseForWorkspaceID(layout, id)).contains(id));
+    }
+
+    // uniform layouts match the plain MonitorRange arithmetic
+    SRangeLayout uniform;
+    buildRangeLayout(uniform, {10, 10}, 10);
+    for (long base = 0; base < 4; base++) {
+        CHECK(rangeForBase(uniform, base).min == MonitorRange(base, 10).min && rangeForBase(uniform, base).max == MonitorRange(base, 10).max);
+    }
+
+    // local numbers are relative to a smaller range
+    CHECK(resolve("3", rangeForBase(layout, 1), 21, {}) == 23);
+    CHECK(resolve("6", rangeForBase(layout, 1), 21, {}) == 22);
+    CHECK(resolve("r+1", rangeForBase(layout, 1), 24, {}) == 21);
+}
+
+static void checkRemap() {
+    SRangeRemap remap;
+    buildRangeLayout(remap.oldLayout, {10, 10}, 10);
+    buildRangeLayout(remap.newLayout, {5, 5}, 5);
+    remap.newBaseByOldBase = {0, 1};
+
+    CHECK(remapWorkspaceID(remap, 3) == 3);
+    CHECK(remapWorkspaceID(remap, 8) == 5);  // collapses onto the last slot
+    CHECK(remapWorkspaceID(remap, 11) == 6);
+    CHECK(remapWorkspaceID(remap, 20) == 10);
+    CHECK(!remapWorkspaceID(remap, 21).has_value()); // no old monitor owned it
+    CHECK(!remapWorkspaceID(remap, 0).has_value());
+
+    // monitors trading bases
+    remap.newBaseByOldBase = {1, 0};
+    CHECK(remapWorkspaceID(remap, 2) == 7);
+    CHECK(remapWorkspaceID(remap, 12) == 2);
+
+    // monitor that went away
+    remap.newBaseByOldBase = {0, -1};
+    CHECK(!remapWorkspaceID(remap, 12).has_value());
+}
+
+static void checkPersistentRules() {
+    const std::vector<SPersistentRule> EXISTING = {{1, "DP-1"}, {2, "DP-1"}, {3, "HDMI-A-1"}, {21, "DP-1"}, {4, "DP-1"}};
+    const auto                         PLAN     = planPersistentRules(EXISTING, {{MonitorRange(0, 2), "DP-1"}, {MonitorRange(1, 2), "HDMI-A-1"}});
+
+    CHECK(PLAN.update.size() == 1 && PLAN.update[0].first == 4 && PLAN.update[0].second == "HDMI-A-1");
+    CHECK(PLAN.add.empty());
+    CHECK(PLAN.remove.size() == 1 && PLAN.remove[0] == 3);
+
+    const auto GROW = planPersistentRules({}, {{MonitorRange(0, 3), "DP-1"}});
+    CHECK(GROW.add.size() == 3 && GROW.add[0].id == 1 && GROW.add[2].id == 3 && GROW.update.empty() && GROW.remove.empty());
+}
+
+static void checkHistory() {
+    const auto        RANGE = MonitorRange(0, 10);
+    SWorkspaceHistory history;
+
+    CHECK(!history.previous(1, RANGE).has_value());
+
+    history.push(1);
+    CHECK(!history.previous(1, RANGE).has_value());
+
+    history.push(3);
+    history.push(3);
+    CHECK(history.previous(3, RANGE) == 1);
+
+    history.push(15); // another monitor's range, skipped
+    history.push(4);
+    CHECK(history.previous(4, RANGE) == 3);
+
+    // older entries are overwritten once the ring is full
+    for (long i = 0; i < (long)SWorkspaceHistory::SIZE; i++) {
+        history.push(5 + (i % 2));
+    }
+    CHECK(history.previous(6, RANGE) == 5);
+    CHECK(history.count == SWorkspaceHistory::SIZE);
+}
+
+static void checkEmpty() {
+    CHECK(findEmptyWorkspace({}, 1, 10) == 1);
+    CHECK(findEmptyWorkspace({1, 2, 4}, 1, 10) == 3);
+    CHECK(findEmptyWorkspace({11, 12}, 11, 12) == std::nullopt);
+    CHECK(findEmptyWorkspace({1, 2, 3}, 2, 5) == 4);
+}
+
+int main() {
+    checkParse();
+    checkResolve();
+    checkLayout();
+    checkRemap();
+    checkPersistentRules();
+    checkHistory();
+    checkEmpty();
+
+    if (g_failures) {
+        std::fprintf(stderr, "%d checks failed\n", g_failures);
+        return 1;
+    }
+
+    std::printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// integer api for other plugins, look the functions up with dlsym on the hyprsplit handle and check hyprsplitAbiVersion() first.
+// nothing here allocates or takes strings. monitor -1 means the focused monitor, functions return -1 / 0 on failure
+
+#include <stdint.h>
+
+#define HYPRSPLIT_ABI_VERSION 1
+
+// workspace request kinds for hyprsplitResolveWorkspace, same meaning as the split:workspace params
+#define HYPRSPLIT_WS_ABSOLUTE      1 // 3
+#define HYPRSPLIT_WS_RELATIVE      2 // +1, no looping
+#define HYPRSPLIT_WS_RELATIVE_WRAP 3 // r+1
+#define HYPRSPLIT_WS_RELATIVE_OPEN 4 // e+1
+#define HYPRSPLIT_WS_RELATIVE_LOOP 5 // m+1
+#define HYPRSPLIT_WS_EMPTY         6 // empty, value is ignored
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t hyprsplitAbiVersion(void);
+
+// 1 and the inclusive workspace id range of the monitor, 0 if it has none
+int32_t hyprsplitGetMonitorRange(int64_t monitor, int64_t* min, int64_t* max);
+
+// workspace id of the 1 based slot on the monitor, -1 if the slot is out of range
+int64_t hyprsplitSlotToWorkspaceID(int64_t monitor, int64_t slot);
+
+// workspace id the request resolves to on the monitor, -1 if it can't be resolved
+int64_t hyprsplitResolveWorkspace(int64_t monitor, int32_t kind, int64_t value);
+
+// 1 if the workspace id is in the monitor's range
+int32_t hyprsplitWorkspaceInRange(int64_t monitor, int64_t workspace);
+
+// id of the monitor whose range contains the workspace id, -1 if none
+int64_t hyprsplitGetMonitorForWorkspace(int64_t workspace);
+
+#ifdef __cplusplus
+}
+#endif
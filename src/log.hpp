@@ -2,6 +2,9 @@
 
 #include <hyprland/src/debug/log/Logger.hpp>
 #include <hyprutils/cli/Logger.hpp>
+#include <iterator>
+#include <string>
+#include <string_view>
 
 using Hyprutils::CLI::eLogLevel;
 
@@ -12,8 +15,25 @@ inline constexpr auto WARN  = Log::WARN;
 inline constexpr auto ERR   = Log::ERR;
 inline constexpr auto CRIT  = Log::CRIT;
 
+// messages below this level are compiled out, e.g. -DHYPRSPLIT_MIN_LOG_LEVEL=INFO
+#ifndef HYPRSPLIT_MIN_LOG_LEVEL
+#define HYPRSPLIT_MIN_LOG_LEVEL TRACE
+#endif
+
+// runtime threshold, set from plugin:hyprsplit:log_level
+inline eLogLevel g_hsLogLevel = DEBUG;
+
 template <typename... Args>
-void hsLog(eLogLevel level, std::format_string<Args...> fmt, Args&&... args) {
-	auto msg = std::vformat(fmt.get(), std::make_format_args(args...));
-	Log::logger->log(level, "[hyprsplit] {}", msg);
+void hsLogImpl(eLogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+	thread_local std::string buffer;
+	buffer.clear();
+	std::vformat_to(std::back_inserter(buffer), fmt.get(), std::make_format_args(args...));
+	Log::logger->log(level, "[hyprsplit] {}", std::string_view{buffer});
 }
+
+// the level check happens before the arguments are evaluated or anything is formatted
+#define hsLog(level, ...) \
+	do { \
+		if ((level) >= HYPRSPLIT_MIN_LOG_LEVEL && (level) >= g_hsLogLevel) \
+			hsLogImpl(level, __VA_ARGS__); \
+	} while (0)
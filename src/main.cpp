@@ -1,12 +1,22 @@
 #include "globals.hpp"
+#include "hyprsplit.h"
 #include "log.hpp"
+#include "split.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <iterator>
+#include <optional>
+#include <regex>
 #include <hyprland/src/desktop/DesktopTypes.hpp>
 #include <hyprland/src/includes.hpp>
 #include <hyprutils/string/String.hpp>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #define private public
@@ -19,71 +29,319 @@
 #include <hyprland/src/helpers/Monitor.hpp>
 #include <hyprland/src/layout/space/Space.hpp>
 #include <hyprland/src/managers/animation/DesktopAnimationManager.hpp>
+#include <hyprland/src/managers/eventLoop/EventLoopManager.hpp>
+#include <hyprland/src/managers/eventLoop/EventLoopTimer.hpp>
 #include <hyprland/src/managers/EventManager.hpp>
 #include <hyprland/src/managers/input/InputManager.hpp>
 #include <hyprland/src/managers/input/trackpad/gestures/ITrackpadGesture.hpp>
+#include <hyprland/src/managers/KeybindManager.hpp>
 #include <hyprland/src/render/Renderer.hpp>
 #undef private
 
 using namespace Hyprutils::String;
 
-static std::vector<std::string> g_monitorPriorities; // "desc:foobar" or "DP-1"
+static std::vector<std::string>                  g_monitorPriorities;      // "desc:foobar" or "DP-1"
+static std::vector<std::pair<std::string, long>> g_monitorWorkspaceCounts; // "desc:foobar" or "DP-1" -> workspaces on it
 
-class MonitorRange {
-  public:
-    long base = -1;
-    long min; // min workspace id on monitor (inclusive)
-    long max; // max workspace id on monitor (inclusive)
+// plugin:hyprsplit:persistent_workspaces
+enum ePersistentMode : uint8_t {
+    PERSISTENT_OFF   = 0,
+    PERSISTENT_EAGER = 1, // every workspace in every range exists at all times
+    PERSISTENT_LAZY  = 2, // workspaces are created on first use and kept afterwards
+};
+
+// monitor <-> workspace range mapping, rebuilt lazily after monitor or hyprsplit config changes
+struct SRangeTable {
+    bool                       dirty         = true;
+    bool                       priorityMode  = false;
+    long                       numWorkspaces = 0;
+    std::vector<long>          baseByMonitor; // indexed by monitor id, -1 if the monitor has no range
+    std::vector<PHLMONITORREF> monitorByBase; // indexed by base
+    SRangeLayout               layout;        // where each base's range starts
+};
+
+static SRangeTable g_rangeTable;
+
+static void invalidateRangeTable() {
+    g_rangeTable.dirty = true;
+}
+
+static void rebuildRangeTable() {
+    static const auto NUMWORKSPACES = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:num_workspaces");
+    static const auto FORCEPRIORITY = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:force_monitor_priority");
 
-    MonitorRange(const PHLMONITOR& monitor) {
-        static const auto FORCEPRIORITY = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:force_monitor_priority");
-        if (g_monitorPriorities.empty() && !*FORCEPRIORITY) {
-            base = monitor->m_id;
-        } else {
+    auto&             t = g_rangeTable;
+    t.baseByMonitor.clear();
+    t.monitorByBase.clear();
+    t.numWorkspaces = *NUMWORKSPACES;
+    t.priorityMode  = !g_monitorPriorities.empty() || *FORCEPRIORITY;
+
+    std::vector<SMonitorDesc> descs;
+    descs.reserve(g_pCompositor->m_monitors.size());
+    for (const auto& m : g_pCompositor->m_monitors) {
+        SMonitorDesc desc = {.id = m->m_id, .name = m->m_name, .mirror = m->isMirror()};
+
+        if (t.priorityMode) {
             for (size_t i = 0; i < g_monitorPriorities.size(); i++) {
-                if (monitor->matchesStaticSelector(g_monitorPriorities[i])) {
-                    base = i;
-                }
-            }
-            if (base == -1) {
-                // find missing monitors
-                std::vector<PHLMONITOR> unmappedMonitors;
-                for (const auto& m : g_pCompositor->m_monitors) {
-                    if (m->m_id == MONITOR_INVALID || m->isMirror())
-                        continue;
-
-                    bool mapped = false;
-                    for (const auto& monitorSelector : g_monitorPriorities) {
-                        if (m->matchesStaticSelector(monitorSelector)) {
-                            mapped = true;
-                            break;
-                        }
-                    }
-                    if (!mapped)
-                        unmappedMonitors.push_back(m);
-                }
-
-                // sort into alphabetical order by name
-                std::ranges::sort(unmappedMonitors, [](const auto& a, const auto& b) -> bool { return a->m_name < b->m_name; });
-
-                for (size_t i = 0; i < unmappedMonitors.size(); i++) {
-                    if (unmappedMonitors[i] == monitor) {
-                        base = i + g_monitorPriorities.size();
-                    }
-                }
+                if (m->matchesStaticSelector(g_monitorPriorities[i]))
+                    desc.priority = i;
             }
         }
 
-        static const auto NUMWORKSPACES = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:num_workspaces");
-        min                             = (base * (*NUMWORKSPACES)) + 1;
-        max                             = (base + 1) * (*NUMWORKSPACES);
+        descs.emplace_back(std::move(desc));
+    }
+
+    assignMonitorBases(descs, t.priorityMode, g_monitorPriorities.size());
+
+    // the last monitor_workspaces entry matching a selector wins
+    const auto countFor = [](const auto& matches) {
+        long count = -1;
+        for (const auto& [SELECTOR, COUNT] : g_monitorWorkspaceCounts) {
+            if (matches(SELECTOR))
+                count = COUNT;
+        }
+        return count;
+    };
+
+    // priorities without a connected monitor keep their range, sized by a monitor_workspaces entry with the same selector
+    std::vector<long> counts(t.priorityMode ? g_monitorPriorities.size() : 0, -1);
+    for (size_t i = 0; i < counts.size(); i++) {
+        counts[i] = countFor([&](const std::string& selector) { return selector == g_monitorPriorities[i]; });
     }
+    for (size_t i = 0; i < descs.size(); i++) {
+        if (descs[i].id < 0 || descs[i].base < 0)
+            continue;
+
+        if ((size_t)descs[i].base >= counts.size())
+            counts.resize(descs[i].base + 1, -1);
+        counts[descs[i].base] = countFor([&](const std::string& selector) { return g_pCompositor->m_monitors[i]->matchesStaticSelector(selector); });
+    }
+    for (auto& c : counts) {
+        if (c < 1)
+            c = t.numWorkspaces;
+    }
+
+    buildRangeLayout(t.layout, counts, t.numWorkspaces);
+
+    for (size_t i = 0; i < descs.size(); i++) {
+        const auto& DESC = descs[i];
+        if (DESC.id < 0 || DESC.base < 0)
+            continue;
+
+        if ((size_t)DESC.id >= t.baseByMonitor.size())
+            t.baseByMonitor.resize(DESC.id + 1, -1);
+        if ((size_t)DESC.base >= t.monitorByBase.size())
+            t.monitorByBase.resize(DESC.base + 1);
 
-    bool contains(const long& num) const {
-        return num >= min && num <= max;
+        t.baseByMonitor[DESC.id]   = DESC.base;
+        t.monitorByBase[DESC.base] = g_pCompositor->m_monitors[i];
     }
+
+    t.dirty = false;
+    hsLog(DEBUG, "rebuilt range table: {} monitors, {} bases", t.baseByMonitor.size(), t.monitorByBase.size());
+}
+
+// config changes invalidate the table explicitly, from the reload handlers or the hyprctl keyword hook
+static const SRangeTable& rangeTable() {
+    if (g_rangeTable.dirty)
+        rebuildRangeTable();
+
+    return g_rangeTable;
+}
+
+static long getMonitorBase(const PHLMONITOR& monitor) {
+    const auto& t = rangeTable();
+
+    if (!monitor)
+        return -1;
+
+    if (monitor->m_id >= 0 && (size_t)monitor->m_id < t.baseByMonitor.size() && t.baseByMonitor[monitor->m_id] != -1)
+        return t.baseByMonitor[monitor->m_id];
+
+    return t.priorityMode ? -1 : monitor->m_id;
+}
+
+static MonitorRange getMonitorRange(const PHLMONITOR& monitor) {
+    return rangeForBase(rangeTable().layout, getMonitorBase(monitor));
+}
+
+// returns the monitor whose range contains the workspace id, if any
+static PHLMONITOR getMonitorForWorkspaceID(WORKSPACEID id) {
+    const auto& t = rangeTable();
+
+    const auto  BASE = baseForWorkspaceID(t.layout, id);
+    if (BASE < 0 || (size_t)BASE >= t.monitorByBase.size())
+        return nullptr;
+
+    return t.monitorByBase[BASE].lock();
+}
+
+using DispatcherFn = decltype(CKeybindManager::m_dispatchers)::mapped_type;
+
+// hyprland dispatchers used by the plugin, looked up once in PLUGIN_INIT instead of by name on every call
+static struct {
+    DispatcherFn* workspace             = nullptr;
+    DispatcherFn* moveToWorkspace       = nullptr;
+    DispatcherFn* moveToWorkspaceSilent = nullptr;
+} g_dispatchers;
+
+static DispatcherFn* resolveDispatcher(const std::string& name) {
+    const auto IT = g_pKeybindManager->m_dispatchers.find(name);
+    if (IT == g_pKeybindManager->m_dispatchers.end()) {
+        hsLog(ERR, "dispatcher {} not found", name);
+        return nullptr;
+    }
+
+    // unordered_map never moves its elements, so the pointer stays valid across rehashes
+    return &IT->second;
+}
+
+// which workspace ids exist and which have mapped windows, kept current from the event bus. windows stay listed on their workspace
+// after they unmap until they are destroyed, so moving a workspace also takes windows that are still fading out with it
+struct SWorkspaceIndex {
+    struct SEntry {
+        WORKSPACEID  workspace = WORKSPACE_INVALID;
+        bool         mapped    = false;
+        PHLWINDOWREF window;
+    };
+
+    SOccupancy                                                 occupancy;
+    std::unordered_map<WORKSPACEID, std::vector<PHLWINDOWREF>> windows;         // workspace id -> windows on it, mapped or not
+    std::unordered_map<WORKSPACEID, size_t>                    mappedCount;     // workspace id -> mapped windows on it
+    std::unordered_map<uintptr_t, SEntry>                      windowWorkspace; // window address -> where it is listed
+    std::vector<std::pair<uintptr_t, PHLWINDOWREF>>            unmapped;        // listed unmapped windows, dropped once destroyed
+    std::unordered_map<uintptr_t, PHLWINDOWREF>                rogue;           // mapped windows on a workspace outside every monitor range
 };
 
+static SWorkspaceIndex g_workspaceIndex;
+
+static void indexRemoveWindow(uintptr_t address) {
+    auto& idx = g_workspaceIndex;
+    idx.rogue.erase(address);
+
+    const auto IT = idx.windowWorkspace.find(address);
+    if (IT == idx.windowWorkspace.end())
+        return;
+
+    const auto WSID   = IT->second.workspace;
+    const bool MAPPED = IT->second.mapped;
+    idx.windowWorkspace.erase(IT);
+
+    if (MAPPED && --idx.mappedCount[WSID] == 0) {
+        idx.mappedCount.erase(WSID);
+        sortedErase(idx.occupancy.occupied, WSID);
+    }
+
+    const auto LISTIT = idx.windows.find(WSID);
+    if (LISTIT == idx.windows.end())
+        return;
+
+    std::erase_if(LISTIT->second, [address](const PHLWINDOWREF& w) { return (uintptr_t)w.get() == address || !w.lock(); });
+
+    if (LISTIT->second.empty())
+        idx.windows.erase(LISTIT);
+}
+
+static void indexAddWindow(const PHLWINDOW& w, WORKSPACEID wsID, bool mapped) {
+    auto&      idx         = g_workspaceIndex;
+
+    const auto PREV        = idx.windowWorkspace.find((uintptr_t)w.get());
+    const bool WASUNMAPPED = PREV != idx.windowWorkspace.end() && !PREV->second.mapped;
+
+    indexRemoveWindow((uintptr_t)w.get());
+
+    if (wsID == WORKSPACE_INVALID)
+        return;
+
+    idx.windowWorkspace[(uintptr_t)w.get()] = {.workspace = wsID, .mapped = mapped, .window = w};
+    idx.windows[wsID].emplace_back(w);
+
+    if (!mapped) {
+        if (!WASUNMAPPED)
+            idx.unmapped.emplace_back((uintptr_t)w.get(), w);
+        return;
+    }
+
+    if (idx.mappedCount[wsID]++ == 0)
+        sortedInsert(idx.occupancy.occupied, wsID);
+
+    // the range lookup is O(1), the workspace lookup only runs for windows outside every range
+    if (!getMonitorForWorkspaceID(wsID)) {
+        const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(wsID);
+        if (!PWORKSPACE || !PWORKSPACE->m_isSpecialWorkspace)
+            idx.rogue.emplace((uintptr_t)w.get(), w);
+    }
+}
+
+// drops the unmapped windows that have been destroyed since, the ones mapped again are no longer tracked here
+static void indexSweepUnmapped() {
+    auto& idx = g_workspaceIndex;
+
+    std::erase_if(idx.unmapped, [&idx](const std::pair<uintptr_t, PHLWINDOWREF>& entry) {
+        const auto& [ADDRESS, WINDOW] = entry;
+        if (const auto PWINDOW = WINDOW.lock())
+            return PWINDOW->m_isMapped;
+
+        // the address may already belong to a new window
+        const auto IT = idx.windowWorkspace.find(ADDRESS);
+        if (IT != idx.windowWorkspace.end() && !IT->second.window.lock())
+            indexRemoveWindow(ADDRESS);
+        return true;
+    });
+}
+
+static void indexUnmapWindow(const PHLWINDOW& w) {
+    indexSweepUnmapped();
+    indexAddWindow(w, w->workspaceID(), false);
+}
+
+static void indexPruneWorkspaces() {
+    std::erase_if(g_workspaceIndex.occupancy.live, [](WORKSPACEID id) {
+        const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(id);
+        return !PWORKSPACE || PWORKSPACE->inert();
+    });
+}
+
+static void rebuildWorkspaceIndex() {
+    auto& idx = g_workspaceIndex;
+    idx.occupancy.live.clear();
+    idx.occupancy.occupied.clear();
+    idx.windows.clear();
+    idx.mappedCount.clear();
+    idx.windowWorkspace.clear();
+    idx.unmapped.clear();
+    idx.rogue.clear();
+
+    for (const auto& ws : g_pCompositor->getWorkspaces()) {
+        if (!valid(ws) || ws->m_isSpecialWorkspace || ws->inert())
+            continue;
+
+        idx.occupancy.live.push_back(ws->m_id);
+    }
+    std::ranges::sort(idx.occupancy.live);
+
+    for (const auto& w : g_pCompositor->m_windows) {
+        indexAddWindow(w, w->workspaceID(), w->m_isMapped);
+    }
+}
+
+// windows on a workspace including unmapped ones, copied so callers can move windows while iterating
+static std::vector<PHLWINDOW> getWindowsOnWorkspace(WORKSPACEID id) {
+    std::vector<PHLWINDOW> result;
+
+    const auto             IT = g_workspaceIndex.windows.find(id);
+    if (IT == g_workspaceIndex.windows.end())
+        return result;
+
+    result.reserve(IT->second.size());
+    for (const auto& w : IT->second) {
+        if (const auto PWINDOW = w.lock())
+            result.emplace_back(PWINDOW);
+    }
+
+    return result;
+}
+
 static std::vector<const char*> HYPRSPLIT_VERSION_VARS = {
     "HYPRSPLIT",
 };
@@ -100,98 +358,175 @@ static void clearHyprSplitVersionEnv() {
     }
 }
 
-static std::string getWorkspaceOnCurrentMonitor(const std::string& workspace) {
+// per monitor workspace history for `previous`, indexed by monitor id. hyprland's history is global and often points into
+// another monitor's range
+static std::vector<SWorkspaceHistory> g_workspaceHistory;
+
+static void recordActiveWorkspace(const PHLWORKSPACE& ws) {
+    const auto PMONITOR = ws ? ws->m_monitor.lock() : nullptr;
+    if (!PMONITOR || PMONITOR->m_id < 0 || ws->m_isSpecialWorkspace)
+        return;
+
+    if ((size_t)PMONITOR->m_id >= g_workspaceHistory.size())
+        g_workspaceHistory.resize(PMONITOR->m_id + 1);
+    g_workspaceHistory[PMONITOR->m_id].push(ws->m_id);
+}
+
+// keybind args are constant strings, so each distinct one is parsed only once. cleared on config reload
+static CWorkspaceArgCache g_workspaceArgCache;
+
+// resolves a workspace param to a workspace id on the current monitor, nullopt if the param should be passed to hyprland as is
+static std::optional<WORKSPACEID> getWorkspaceIDOnCurrentMonitor(std::string_view workspace) {
     if (!Desktop::focusState()->monitor()) {
         hsLog(ERR, "no monitor in getWorkspaceOnCurrentMonitor?");
-        return workspace;
+        return std::nullopt;
     }
 
-    int               wsID          = 1;
-    static const auto NUMWORKSPACES = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:num_workspaces");
-    const auto        PMONITOR      = Desktop::focusState()->monitor();
-    const auto        RANGE         = MonitorRange(PMONITOR);
+    const auto  PMONITOR = Desktop::focusState()->monitor();
+    const auto& ARG      = getCachedWorkspaceArg(g_workspaceArgCache, workspace);
 
-    if (workspace[0] == '+' || workspace[0] == '-') {
-        const long LOCALCURRENT    = PMONITOR->activeWorkspaceID() - RANGE.min + 1;
-        const auto PLUSMINUSRESULT = getPlusMinusKeywordResult(workspace, LOCALCURRENT);
+    // without an in-range entry stay put, hyprland's global history would jump into another monitor's range
+    if (ARG.kind == WSARG_PREVIOUS) {
+        if (PMONITOR->m_id < 0 || (size_t)PMONITOR->m_id >= g_workspaceHistory.size())
+            return PMONITOR->activeWorkspaceID();
 
-        if (!PLUSMINUSRESULT.has_value())
-            return workspace;
+        return g_workspaceHistory[PMONITOR->m_id].previous(PMONITOR->activeWorkspaceID(), getMonitorRange(PMONITOR)).value_or(PMONITOR->activeWorkspaceID());
+    }
 
-        wsID = std::max((int)PLUSMINUSRESULT.value(), 1);
-        wsID = std::min(wsID, (int)*NUMWORKSPACES);
-    } else if (isNumber(workspace)) {
-        wsID = std::max(std::stoi(workspace), 1);
-    } else if (workspace[0] == 'r' && (workspace[1] == '-' || workspace[1] == '+') && isNumber(workspace.substr(2))) {
-        const auto PLUSMINUSRESULT = getPlusMinusKeywordResult(workspace.substr(1), PMONITOR->activeWorkspaceID());
+    return resolveWorkspaceArg(ARG, getMonitorRange(PMONITOR), PMONITOR->activeWorkspaceID(), g_workspaceIndex.occupancy);
+}
 
-        if (!PLUSMINUSRESULT.has_value())
-            return workspace;
+static std::string getWorkspaceOnCurrentMonitor(const std::string& workspace) {
+    const auto WORKSPACEID = getWorkspaceIDOnCurrentMonitor(workspace);
+    return WORKSPACEID.has_value() ? std::to_string(WORKSPACEID.value()) : workspace;
+}
 
-        wsID = (int)PLUSMINUSRESULT.value();
+// brings the hyprsplit persistent workspace rules in line with the current monitor ranges in one pass
+static void reconcilePersistentWorkspaceRules() {
+    auto&                                             rules = Config::workspaceRuleMgr()->m_rules;
 
-        if (wsID <= 0)
-            wsID = ((((wsID - 1) % *NUMWORKSPACES) + *NUMWORKSPACES) % *NUMWORKSPACES) + 1;
-    } else if (workspace[0] == 'e' && (workspace[1] == '-' || workspace[1] == '+') && isNumber(workspace.substr(2))) {
-        const auto PLUSMINUSRESULT = getPlusMinusKeywordResult(workspace.substr(1), 0);
+    std::vector<size_t>                               ruleIndices; // index into rules of each existing hyprsplit rule
+    std::vector<SPersistentRule>                      existing;
+    std::vector<std::pair<MonitorRange, std::string>> desired;
 
-        if (!PLUSMINUSRESULT.has_value())
-            return workspace;
+    for (size_t i = 0; i < rules.size(); i++) {
+        if (!rules[i].m_layoutopts.contains("hyprsplit"))
+            continue;
 
-        const int                PLUSMINUSVALUE = (int)PLUSMINUSRESULT.value();
+        ruleIndices.push_back(i);
+        existing.emplace_back(SPersistentRule{rules[i].m_workspaceId, rules[i].m_monitor});
+    }
 
-        std::vector<WORKSPACEID> validWSes;
-        for (auto const& ws : g_pCompositor->getWorkspaces()) {
-            if (ws->m_isSpecialWorkspace || ws->m_monitor != PMONITOR)
-                continue;
+    for (auto& m : g_pCompositor->m_monitors) {
+        if (!m || m->m_id == MONITOR_INVALID || m->isMirror())
+            continue;
 
-            validWSes.push_back(ws->m_id);
-        }
-        std::ranges::sort(validWSes);
+        desired.emplace_back(getMonitorRange(m), m->m_name);
+    }
 
-        auto findResult = std::ranges::find(validWSes.begin(), validWSes.end(), PMONITOR->activeWorkspaceID());
-        if (findResult == validWSes.end())
-            return workspace;
-        size_t current = findResult - validWSes.begin();
+    const auto PLAN = planPersistentRules(existing, desired);
 
-        int    resultIndex = current + PLUSMINUSVALUE;
-        if (resultIndex < 0)
-            resultIndex = 0;
-        else if ((size_t)resultIndex >= validWSes.size())
-            resultIndex = validWSes.size() - 1;
-        WORKSPACEID result = validWSes[resultIndex];
+    for (const auto& [INDEX, MONITOR] : PLAN.update) {
+        rules[ruleIndices[INDEX]].m_monitor = MONITOR;
+    }
 
-        return std::to_string(result);
-    } else if (workspace.starts_with("empty")) {
-        for (long id = RANGE.min; id <= RANGE.max; id++) {
-            const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(id);
-            if (!PWORKSPACE || (PWORKSPACE->getWindows() == 0))
-                return std::to_string(id);
-        }
+    // back to front so earlier indices stay valid
+    for (auto it = PLAN.remove.rbegin(); it != PLAN.remove.rend(); it++) {
+        rules.erase(rules.begin() + ruleIndices[*it]);
+    }
 
-        hsLog(DEBUG, "no empty workspace on monitor");
-        return std::to_string(PMONITOR->activeWorkspaceID());
-    } else {
-        return workspace;
+    for (const auto& RULE : PLAN.add) {
+        Config::CWorkspaceRule wsRule;
+        wsRule.m_workspaceString         = std::to_string(RULE.id);
+        wsRule.m_workspaceId             = RULE.id;
+        wsRule.m_workspaceName           = wsRule.m_workspaceString;
+        wsRule.m_isPersistent            = true;
+        wsRule.m_monitor                 = RULE.monitor;
+        wsRule.m_layoutopts["hyprsplit"] = "1";
+        rules.emplace_back(std::move(wsRule));
     }
 
-    if (wsID > *NUMWORKSPACES)
-        wsID = ((wsID - 1) % *NUMWORKSPACES) + 1;
+    hsLog(DEBUG, "persistent workspace rules: {} added, {} updated, {} removed", PLAN.add.size(), PLAN.update.size(), PLAN.remove.size());
 
-    return std::to_string(RANGE.min + wsID - 1);
+    g_pCompositor->ensurePersistentWorkspacesPresent(Config::workspaceRuleMgr()->getAllWorkspaceRules());
 }
 
-static void ensureGoodWorkspaces() {
-    if (g_pCompositor->m_unsafeState)
+// lazily persistent workspaces: nothing is created up front, a workspace in a monitor range is made persistent when hyprland
+// first creates it (focused or received a window). `hyprctl hyprsplit workspaces` reports the not yet created ones
+static std::vector<long> g_lazyPersistentWorkspaces; // sorted ids we marked persistent
+
+static void markLazyPersistent(const PHLWORKSPACE& ws) {
+    if (ws->m_isSpecialWorkspace || !getMonitorForWorkspaceID(ws->m_id))
         return;
 
+    ws->setPersistent(true);
+    sortedInsert(g_lazyPersistentWorkspaces, ws->m_id);
+}
+
+static void clearLazyPersistentWorkspaces() {
+    for (const auto ID : g_lazyPersistentWorkspaces) {
+        if (const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(ID))
+            PWORKSPACE->setPersistent(false);
+    }
+    g_lazyPersistentWorkspaces.clear();
+}
+
+static void reconcileLazyPersistentWorkspaces() {
+    // switching from eager persistence leaves rules behind
+    const auto REMOVED = std::erase_if(Config::workspaceRuleMgr()->m_rules, [](Config::CWorkspaceRule const& rule) { return rule.m_layoutopts.contains("hyprsplit"); });
+    if (REMOVED)
+        g_pCompositor->ensurePersistentWorkspacesPresent(Config::workspaceRuleMgr()->getAllWorkspaceRules());
+
+    // workspaces whose monitor went away stop being persistent so they can be cleaned up once empty
+    std::erase_if(g_lazyPersistentWorkspaces, [](long id) {
+        if (getMonitorForWorkspaceID(id))
+            return false;
+
+        if (const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(id))
+            PWORKSPACE->setPersistent(false);
+        return true;
+    });
+
+    for (const auto& ws : g_pCompositor->getWorkspaces()) {
+        if (valid(ws))
+            markLazyPersistent(ws.lock());
+    }
+}
+
+// the compositor calls that make up hotplug timelines, traced when `hyprctl hyprsplit trace start` is on
+static void moveWorkspaceToMonitor(const PHLWORKSPACE& ws, const PHLMONITOR& m) {
+    CTraceSpan span("moveWorkspaceToMonitor", "workspace", ws->m_id);
+    g_pCompositor->moveWorkspaceToMonitor(ws, m);
+}
+
+static void changeWorkspace(const PHLMONITOR& m, const PHLWORKSPACE& ws) {
+    CTraceSpan span("changeWorkspace", "workspace", ws->m_id);
+    m->changeWorkspace(ws, false, true, true);
+}
+
+static void reconcilePersistence() {
     static const auto PERSISTENT = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:persistent_workspaces");
 
+    if (*PERSISTENT == PERSISTENT_LAZY)
+        reconcileLazyPersistentWorkspaces();
+    else
+        clearLazyPersistentWorkspaces();
+
+    if (*PERSISTENT == PERSISTENT_EAGER)
+        reconcilePersistentWorkspaceRules();
+}
+
+static void ensureGoodWorkspaces() {
+    CStatsTimer timer(STATS_ENSUREGOODWORKSPACES);
+
+    if (g_pCompositor->m_unsafeState)
+        return;
+
     for (auto& m : g_pCompositor->m_monitors) {
         if (!m || m->m_id == MONITOR_INVALID || m->isMirror())
             continue;
 
-        const auto RANGE = MonitorRange(m);
+        const auto RANGE = getMonitorRange(m);
 
         if (!RANGE.contains(m->activeWorkspaceID())) {
             hsLog(DEBUG, "{} base {} active workspace {} out of bounds, changing workspace to {}", m->m_name, RANGE.base, m->activeWorkspaceID(), RANGE.min);
@@ -200,53 +535,35 @@ static void ensureGoodWorkspaces() {
             if (!ws) {
                 ws = g_pCompositor->createNewWorkspace(RANGE.min, m->m_id);
             } else if (ws->monitorID() != m->m_id) {
-                g_pCompositor->moveWorkspaceToMonitor(ws, m);
+                moveWorkspaceToMonitor(ws, m);
             }
 
-            m->changeWorkspace(ws, false, true, true);
+            changeWorkspace(m, ws);
         }
     }
 
-    for (auto& m : g_pCompositor->m_monitors) {
-        if (!m || m->m_id == MONITOR_INVALID || m->isMirror())
+    for (const auto& ws : g_pCompositor->getWorkspacesCopy()) {
+        if (!valid(ws))
             continue;
 
-        const auto RANGE = MonitorRange(m);
-
-        for (const auto& ws : g_pCompositor->getWorkspacesCopy()) {
-            if (!valid(ws))
-                continue;
-
-            if (ws->monitorID() != m->m_id && RANGE.contains(ws->m_id)) {
-                hsLog(DEBUG, "workspace {} on monitor {} move to {} {}", ws->m_id, ws->monitorID(), m->m_name, RANGE.base);
-                g_pCompositor->moveWorkspaceToMonitor(ws, m);
-            }
-        }
+        const auto m = getMonitorForWorkspaceID(ws->m_id);
+        if (!m || m->m_id == MONITOR_INVALID || m->isMirror())
+            continue;
 
-        if (*PERSISTENT) {
-            for (auto i = RANGE.min; i <= RANGE.max; i++) {
-                Config::CWorkspaceRule wsRule;
-                wsRule.m_workspaceString         = std::to_string(i);
-                wsRule.m_workspaceId             = i;
-                wsRule.m_workspaceName           = wsRule.m_workspaceString;
-                wsRule.m_isPersistent            = true;
-                wsRule.m_monitor                 = m->m_name;
-                wsRule.m_layoutopts["hyprsplit"] = "1";
-
-                const auto IT = std::ranges::find_if(Config::workspaceRuleMgr()->m_rules,
-                                                     [&](const auto& other) { return other.m_layoutopts.contains("hyprsplit") && other.m_workspaceId == wsRule.m_workspaceId; });
-
-                if (IT == Config::workspaceRuleMgr()->m_rules.end())
-                    Config::workspaceRuleMgr()->m_rules.emplace_back(wsRule);
-                else
-                    IT->m_monitor = wsRule.m_monitor;
-                g_pCompositor->ensurePersistentWorkspacesPresent(Config::workspaceRuleMgr()->getAllWorkspaceRules());
-            }
+        if (ws->monitorID() != m->m_id) {
+            hsLog(DEBUG, "workspace {} on monitor {} move to {} {}", ws->m_id, ws->monitorID(), m->m_name, getMonitorBase(m));
+            moveWorkspaceToMonitor(ws, m);
         }
     }
+
+    reconcilePersistence();
 }
 
+// the param is resolved to an id here, the switch itself is left to hyprland's workspace dispatcher. it also handles back and forth,
+// hiding the special workspace, focus history and cursor warping, so only the name of the resolved workspace goes back through it
 static SDispatchResult focusWorkspace(std::string args) {
+    CStatsTimer timer(STATS_WORKSPACE);
+
     const auto PCURRMONITOR = Desktop::focusState()->monitor();
 
     if (!PCURRMONITOR) {
@@ -254,7 +571,8 @@ static SDispatchResult focusWorkspace(std::string args) {
         return {.success = false, .error = "focusWorkspace: monitor doesn't exist"};
     }
 
-    const int WORKSPACEID = getWorkspaceIDNameFromString(getWorkspaceOnCurrentMonitor(args)).id;
+    const auto RESOLVEDID  = getWorkspaceIDOnCurrentMonitor(args);
+    const int  WORKSPACEID = RESOLVEDID.has_value() ? RESOLVEDID.value() : getWorkspaceIDNameFromString(args).id;
 
     if (WORKSPACEID == WORKSPACE_INVALID) {
         hsLog(ERR, "focusWorkspace: invalid workspace");
@@ -264,40 +582,143 @@ static SDispatchResult focusWorkspace(std::string args) {
     auto PWORKSPACE = g_pCompositor->getWorkspaceByID(WORKSPACEID);
     if (!PWORKSPACE) {
         PWORKSPACE = g_pCompositor->createNewWorkspace(WORKSPACEID, PCURRMONITOR->m_id);
-        g_pKeybindManager->m_dispatchers["workspace"](PWORKSPACE->getConfigName());
+        (*g_dispatchers.workspace)(PWORKSPACE->getConfigName());
         return {};
     }
 
-    const auto RANGE = MonitorRange(PCURRMONITOR);
+    const auto RANGE = getMonitorRange(PCURRMONITOR);
     if (PWORKSPACE->monitorID() != PCURRMONITOR->m_id && (RANGE.contains(WORKSPACEID))) {
         hsLog(WARN, "focusWorkspace: workspace exists but is on the wrong monitor?");
         ensureGoodWorkspaces();
     }
-    g_pKeybindManager->m_dispatchers["workspace"](PWORKSPACE->getConfigName());
+    (*g_dispatchers.workspace)(PWORKSPACE->getConfigName());
     return {};
 }
 
+// rewrites the workspace part of "workspace" or "workspace,window" in place
+static void resolveMoveArgs(std::string& args) {
+    const auto COMMA       = args.find_last_of(',');
+    const auto WORKSPACEID = getWorkspaceIDOnCurrentMonitor(std::string_view{args}.substr(0, COMMA));
+
+    if (WORKSPACEID.has_value())
+        args.replace(0, COMMA == std::string::npos ? args.size() : COMMA, std::to_string(WORKSPACEID.value()));
+}
+
 static SDispatchResult moveToWorkspace(std::string args) {
-    if (args.contains(','))
-        args = getWorkspaceOnCurrentMonitor(args.substr(0, args.find_last_of(','))) + "," + args.substr(args.find_last_of(',') + 1);
-    else
-        args = getWorkspaceOnCurrentMonitor(args);
+    CStatsTimer timer(STATS_MOVETOWORKSPACE);
 
-    g_pKeybindManager->m_dispatchers["movetoworkspace"](args);
+    resolveMoveArgs(args);
+
+    (*g_dispatchers.moveToWorkspace)(std::move(args));
     return {};
 }
 
 static SDispatchResult moveToWorkspaceSilent(std::string args) {
-    if (args.contains(','))
-        args = getWorkspaceOnCurrentMonitor(args.substr(0, args.find_last_of(','))) + "," + args.substr(args.find_last_of(',') + 1);
-    else
-        args = getWorkspaceOnCurrentMonitor(args);
+    CStatsTimer timer(STATS_MOVETOWORKSPACESILENT);
 
-    g_pKeybindManager->m_dispatchers["movetoworkspacesilent"](args);
+    resolveMoveArgs(args);
+
+    (*g_dispatchers.moveToWorkspaceSilent)(std::move(args));
     return {};
 }
 
+// moves the windows and layout of every `from` workspace onto its `to` workspace, the moves must form a permutation. windows are
+// looked up once and retargeted in a single pass, each affected monitor is recalculated and damaged once and focus is
+// restored once at the end. with coalesce_swap_events the per window IPC events become one `hyprsplit>>header,<address>:<ws> ...`
+static void permuteWorkspaces(const std::vector<std::pair<PHLWORKSPACE, PHLWORKSPACE>>& moves, std::string coalescedHeader) {
+    static const auto                          COALESCE = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:coalesce_swap_events");
+
+    std::vector<std::vector<PHLWINDOW>>        windows;
+    std::vector<decltype(CWorkspace::m_space)> spaces;
+    std::vector<PHLMONITOR>                    affectedMonitors;
+    windows.reserve(moves.size());
+    spaces.reserve(moves.size());
+
+    // everything is read before anything is written, so cycles don't see half moved state
+    for (const auto& [FROM, TO] : moves) {
+        windows.emplace_back(getWindowsOnWorkspace(FROM->m_id));
+        spaces.emplace_back(FROM->m_space);
+
+        for (const auto& m : {FROM->m_monitor.lock(), TO->m_monitor.lock()}) {
+            if (m && std::ranges::find(affectedMonitors, m) == affectedMonitors.end())
+                affectedMonitors.push_back(m);
+        }
+    }
+
+    for (size_t i = 0; i < moves.size(); i++) {
+        const auto& [FROM, TO] = moves[i];
+        const auto FROMMON     = FROM->m_monitor.lock();
+        const auto TOMON       = TO->m_monitor.lock();
+
+        for (const auto& w : windows[i]) {
+            w->m_workspace = TO;
+            w->m_monitor   = TOMON;
+
+            // additionally, move floating and fs windows manually
+            if (w->m_isFloating && FROMMON && TOMON && FROMMON != TOMON)
+                w->layoutTarget()->setPositionGlobal(w->layoutTarget()->position().translate(-FROMMON->m_position + TOMON->m_position));
+
+            if (w->isFullscreen()) {
+                *w->m_realPosition = TOMON->m_position;
+                *w->m_realSize     = TOMON->m_size;
+            }
+
+            w->updateToplevel();
+        }
+
+        spaces[i]->m_parent = TO;
+        TO->m_space         = spaces[i];
+    }
+
+    for (const auto& [FROM, TO] : moves) {
+        TO->updateWindows();
+    }
+
+    for (const auto& m : affectedMonitors) {
+        g_layoutManager->recalculateMonitor(m);
+        g_pHyprRenderer->damageMonitor(m);
+    }
+
+    for (const auto& [FROM, TO] : moves) {
+        if (TO->isVisible())
+            g_pDesktopAnimationManager->setFullscreenFadeAnimation(TO, TO->m_hasFullscreenWindow ? CDesktopAnimationManager::ANIMATION_TYPE_IN : CDesktopAnimationManager::ANIMATION_TYPE_OUT);
+    }
+
+    g_pInputManager->refocus();
+
+    // instead of moveworkspace events, we should send movewindow events
+    size_t numWindows = 0;
+    for (size_t i = 0; i < moves.size(); i++) {
+        const auto& TO = moves[i].second;
+        for (const auto& w : windows[i]) {
+            if (!*COALESCE) {
+                g_pEventManager->postEvent(SHyprIPCEvent{"movewindow", std::format("{:x},{}", (uintptr_t)w.get(), TO->m_name)});
+                g_pEventManager->postEvent(SHyprIPCEvent{"movewindowv2", std::format("{:x},{},{}", (uintptr_t)w.get(), TO->m_id, TO->m_name)});
+            }
+            Event::bus()->m_events.window.moveToWorkspace.emit(w, TO);
+        }
+        numWindows += windows[i].size();
+    }
+
+    if (!*COALESCE)
+        return;
+
+    std::string data = std::move(coalescedHeader);
+    data.reserve(data.size() + 1 + (numWindows * 24));
+    data += ',';
+    for (size_t i = 0; i < moves.size(); i++) {
+        for (const auto& w : windows[i]) {
+            std::format_to(std::back_inserter(data), "{:x}:{} ", (uintptr_t)w.get(), moves[i].second->m_id);
+        }
+    }
+    data.pop_back();
+
+    g_pEventManager->postEvent(SHyprIPCEvent{"hyprsplit", std::move(data)});
+}
+
 static SDispatchResult swapActiveWorkspaces(std::string args) {
+    CStatsTimer timer(STATS_SWAPACTIVEWORKSPACES);
+
     const auto MON1 = args.substr(0, args.find_first_of(' '));
     const auto MON2 = args.substr(args.find_first_of(' ') + 1);
 
@@ -313,83 +734,220 @@ static SDispatchResult swapActiveWorkspaces(std::string args) {
     if (!PWORKSPACEA || !valid(PWORKSPACEA) || !PWORKSPACEB || !valid(PWORKSPACEB))
         return {};
 
-    // move windows
-    // <std::string> fsWindows;
-    for (auto& w : g_pCompositor->m_windows) {
-        if (w->m_workspace == PWORKSPACEA) {
-            w->m_workspace = PWORKSPACEB;
-            w->m_monitor   = PMON2;
+    // swapactiveworkspaces,<ws a>,<ws b>,<address>:<new ws> ...
+    permuteWorkspaces({{PWORKSPACEA, PWORKSPACEB}, {PWORKSPACEB, PWORKSPACEA}}, std::format("swapactiveworkspaces,{},{}", PWORKSPACEA->m_id, PWORKSPACEB->m_id));
+    return {};
+}
 
-            // additionally, move floating and fs windows manually
-            if (w->m_isFloating)
-                w->layoutTarget()->setPositionGlobal(w->layoutTarget()->position().translate(-PMON1->m_position + PMON2->m_position));
+// split:rotateactiveworkspaces <monitor> <monitor> ... | all
+// the active workspace contents of each monitor move to the next one in the list, the last wraps around to the first
+static SDispatchResult rotateActiveWorkspaces(std::string args) {
+    CStatsTimer             timer(STATS_ROTATEACTIVEWORKSPACES);
 
-            if (w->isFullscreen()) {
-                *w->m_realPosition = PMON2->m_position;
-                *w->m_realSize     = PMON2->m_size;
-            }
+    std::vector<PHLMONITOR> monitors;
+    if (args.empty() || args == "all") {
+        for (const auto& m : g_pCompositor->m_monitors) {
+            if (m && m->m_id != MONITOR_INVALID && !m->isMirror())
+                monitors.push_back(m);
+        }
+        // in workspace range order, i.e. the order monitor_priority assigns them
+        std::ranges::sort(monitors, [](const PHLMONITOR& a, const PHLMONITOR& b) { return getMonitorBase(a) < getMonitorBase(b); });
+    } else {
+        CVarList2 monitorArgs(std::move(args), 0, ' ');
+        for (size_t i = 0; i < monitorArgs.size(); i++) {
+            const auto PMONITOR = g_pCompositor->getMonitorFromString(std::string{monitorArgs[i]});
+            if (!PMONITOR)
+                return {.success = false, .error = std::format("rotateactiveworkspaces: no monitor {}", monitorArgs[i])};
+            if (std::ranges::find(monitors, PMONITOR) != monitors.end())
+                return {.success = false, .error = std::format("rotateactiveworkspaces: monitor {} listed twice", monitorArgs[i])};
+
+            monitors.push_back(PMONITOR);
+        }
+    }
 
-            w->updateToplevel();
-        } else if (w->m_workspace == PWORKSPACEB) {
-            w->m_workspace = PWORKSPACEA;
-            w->m_monitor   = PMON1;
+    if (monitors.size() < 2)
+        return {};
 
-            // additionally, move floating and fs windows manually
-            if (w->m_isFloating)
-                w->layoutTarget()->setPositionGlobal(w->layoutTarget()->position().translate(-PMON2->m_position + PMON1->m_position));
+    std::vector<std::pair<PHLWORKSPACE, PHLWORKSPACE>> moves;
+    std::string                                        header = "rotateactiveworkspaces";
+    for (size_t i = 0; i < monitors.size(); i++) {
+        const auto PFROM = monitors[i]->m_activeWorkspace;
+        const auto PTO   = monitors[(i + 1) % monitors.size()]->m_activeWorkspace;
+        if (!PFROM || !valid(PFROM) || !PTO || !valid(PTO))
+            return {};
 
-            if (w->isFullscreen()) {
-                *w->m_realPosition = PMON1->m_position;
-                *w->m_realSize     = PMON1->m_size;
-            }
+        moves.emplace_back(PFROM, PTO);
+        std::format_to(std::back_inserter(header), ",{}", PFROM->m_id);
+    }
 
-            w->updateToplevel();
+    // rotateactiveworkspaces,<ws 1>,...,<ws n>,<address>:<new ws> ...
+    permuteWorkspaces(moves, std::move(header));
+    return {};
+}
+
+// split:swapmonitors <monitor> <monitor> exchanges the contents of every workspace in the two ranges slot by slot, each monitor keeps
+// its active slot. when one range is larger its extra slots are left alone. workspaces that only exist on one side are created on the other, all swaps go through one permutation
+static SDispatchResult swapMonitors(std::string args) {
+    CStatsTimer timer(STATS_SWAPMONITORS);
+
+    const auto PMON1 = g_pCompositor->getMonitorFromString(args.substr(0, args.find_first_of(' ')));
+    const auto PMON2 = g_pCompositor->getMonitorFromString(args.substr(args.find_first_of(' ') + 1));
+
+    if (!PMON1 || !PMON2 || PMON1 == PMON2)
+        return {.success = false, .error = "swapmonitors: expected two different monitors"};
+
+    const auto RANGE1 = getMonitorRange(PMON1);
+    const auto RANGE2 = getMonitorRange(PMON2);
+    if (RANGE1.base < 0 || RANGE2.base < 0)
+        return {.success = false, .error = "swapmonitors: monitor has no workspace range"};
+
+    // with monitor_workspaces the ranges can differ in size, slots past the smaller one stay where they are
+    std::vector<std::pair<PHLWORKSPACE, PHLWORKSPACE>> moves;
+    for (long slot = 0; slot < std::min(RANGE1.size(), RANGE2.size()); slot++) {
+        auto PWORKSPACE1 = g_pCompositor->getWorkspaceByID(RANGE1.min + slot);
+        auto PWORKSPACE2 = g_pCompositor->getWorkspaceByID(RANGE2.min + slot);
+
+        if (!PWORKSPACE1 && !PWORKSPACE2)
+            continue;
+
+        if (!PWORKSPACE1)
+            PWORKSPACE1 = g_pCompositor->createNewWorkspace(RANGE1.min + slot, PMON1->m_id);
+        if (!PWORKSPACE2)
+            PWORKSPACE2 = g_pCompositor->createNewWorkspace(RANGE2.min + slot, PMON2->m_id);
+
+        moves.emplace_back(PWORKSPACE1, PWORKSPACE2);
+        moves.emplace_back(PWORKSPACE2, PWORKSPACE1);
+    }
+
+    if (moves.empty())
+        return {};
+
+    // swapmonitors,<monitor a>,<monitor b>,<address>:<new ws> ...
+    permuteWorkspaces(moves, std::format("swapmonitors,{},{}", PMON1->m_name, PMON2->m_name));
+    return {};
+}
+
+// moves windows to a workspace in one retarget pass, the same way permuteWorkspaces moves whole workspaces: each window is taken
+// out of its old layout space and put into the target's, then every touched workspace updates its windows once, each affected
+// monitor is recalculated and damaged once and the move events go out at the end. fullscreen windows go through hyprland's own
+// move, which drops and restores their fullscreen state
+static size_t moveWindowsToWorkspace(const std::vector<PHLWINDOW>& windows, const PHLWORKSPACE& target) {
+    if (windows.empty() || !valid(target))
+        return 0;
+
+    CTraceSpan                span("moveWindowsToWorkspace", "workspace", target->m_id);
+
+    const auto                TOMON        = target->m_monitor.lock();
+    const auto                PFOCUSED     = Desktop::focusState()->window();
+    bool                      movedFocused = false;
+    std::vector<PHLWINDOW>    moved;
+    std::vector<PHLWORKSPACE> sources;
+    std::vector<PHLMONITOR>   affectedMonitors;
+
+    const auto                addAffected = [&](const PHLMONITOR& m) {
+        if (m && std::ranges::find(affectedMonitors, m) == affectedMonitors.end())
+            affectedMonitors.push_back(m);
+    };
+
+    addAffected(TOMON);
+
+    size_t count = 0;
+    for (const auto& w : windows) {
+        if (!w->m_isMapped || w->m_workspace == target)
+            continue;
+
+        hsLog(DEBUG, "moving window {} to workspace {}", w->m_title, target->m_id);
+
+        movedFocused |= w == PFOCUSED;
+
+        if (w->isFullscreen()) {
+            CTraceSpan safeSpan("moveWindowToWorkspaceSafe", "workspace", target->m_id);
+            g_pCompositor->moveWindowToWorkspaceSafe(w, target);
+            count++;
+            continue;
         }
+
+        const auto FROM    = w->m_workspace;
+        const auto FROMMON = w->m_monitor.lock();
+        addAffected(FROMMON);
+        if (FROM && std::ranges::find(sources, FROM) == sources.end())
+            sources.push_back(FROM);
+
+        w->m_workspace = target;
+        w->m_monitor   = TOMON;
+        w->layoutTarget()->assignToSpace(target->m_space);
+
+        // additionally, move floating windows manually
+        if (w->m_isFloating && FROMMON && TOMON && FROMMON != TOMON)
+            w->layoutTarget()->setPositionGlobal(w->layoutTarget()->position().translate(-FROMMON->m_position + TOMON->m_position));
+
+        w->updateToplevel();
+        moved.push_back(w);
+        count++;
     }
 
-    // swap layouts
-    auto workspaceLayoutA = PWORKSPACEA->m_space;
-    auto workspaceLayoutB = PWORKSPACEB->m_space;
+    if (!moved.empty()) {
+        target->updateWindows();
+        for (const auto& ws : sources) {
+            if (valid(ws))
+                ws->updateWindows();
+        }
 
-    workspaceLayoutA->m_parent = PWORKSPACEB;
-    workspaceLayoutB->m_parent = PWORKSPACEA;
+        for (const auto& m : affectedMonitors) {
+            g_layoutManager->recalculateMonitor(m);
+            g_pHyprRenderer->damageMonitor(m);
+        }
+    }
+
+    // like movetoworkspacesilent, don't follow the focused window
+    if (movedFocused)
+        g_pInputManager->refocus();
 
-    PWORKSPACEA->m_space = workspaceLayoutB;
-    PWORKSPACEB->m_space = workspaceLayoutA;
+    for (const auto& w : moved) {
+        g_pEventManager->postEvent(SHyprIPCEvent{"movewindow", std::format("{:x},{}", (uintptr_t)w.get(), target->m_name)});
+        g_pEventManager->postEvent(SHyprIPCEvent{"movewindowv2", std::format("{:x},{},{}", (uintptr_t)w.get(), target->m_id, target->m_name)});
+        Event::bus()->m_events.window.moveToWorkspace.emit(w, target);
+    }
 
-    PWORKSPACEA->updateWindows();
-    PWORKSPACEB->updateWindows();
+    return count;
+}
 
-    g_layoutManager->recalculateMonitor(PMON1);
-    g_layoutManager->recalculateMonitor(PMON2);
+// where the windows of a disconnected monitor were, relative to its range, so a reconnect can put them back
+struct SMonitorSnapshot {
+    struct SEntry {
+        PHLWINDOWREF window;
+        WORKSPACEID  workspace; // id at disconnect, the window is only restored if it is still there
+        long         slot;      // 0 based index into the monitor's range
+    };
 
-    g_pHyprRenderer->damageMonitor(PMON1);
-    g_pHyprRenderer->damageMonitor(PMON2);
+    std::vector<SEntry> entries;
+};
 
-    g_pDesktopAnimationManager->setFullscreenFadeAnimation(
-        PWORKSPACEB, PWORKSPACEB->m_hasFullscreenWindow ? CDesktopAnimationManager::ANIMATION_TYPE_IN : CDesktopAnimationManager::ANIMATION_TYPE_OUT);
-    g_pDesktopAnimationManager->setFullscreenFadeAnimation(
-        PWORKSPACEA, PWORKSPACEA->m_hasFullscreenWindow ? CDesktopAnimationManager::ANIMATION_TYPE_IN : CDesktopAnimationManager::ANIMATION_TYPE_OUT);
+static std::unordered_map<std::string, SMonitorSnapshot> g_monitorSnapshots; // static selector -> snapshot
 
-    g_pInputManager->refocus();
+// moves every window outside all monitor ranges to the target, the index keeps the rogue set current so this is O(rogue)
+static size_t regroupRogueWindows(const PHLWORKSPACE& target) {
+    std::vector<PHLWINDOW> rogueWindows;
+    rogueWindows.reserve(g_workspaceIndex.rogue.size());
+    for (const auto& [ADDRESS, WINDOW] : g_workspaceIndex.rogue) {
+        if (const auto PWINDOW = WINDOW.lock())
+            rogueWindows.emplace_back(PWINDOW);
+    }
 
-    // instead of moveworkspace events, we should send movewindow events
-    for (auto& w : g_pCompositor->m_windows) {
-        if (w->workspaceID() == PWORKSPACEA->m_id) {
-            g_pEventManager->postEvent(SHyprIPCEvent{"movewindow", std::format("{:x},{}", (uintptr_t)w.get(), PWORKSPACEA->m_name)});
-            g_pEventManager->postEvent(SHyprIPCEvent{"movewindowv2", std::format("{:x},{},{}", (uintptr_t)w.get(), PWORKSPACEA->m_id, PWORKSPACEA->m_name)});
-            Event::bus()->m_events.window.moveToWorkspace.emit(w, PWORKSPACEA);
-        } else if (w->workspaceID() == PWORKSPACEB->m_id) {
-            g_pEventManager->postEvent(SHyprIPCEvent{"movewindow", std::format("{:x},{}", (uintptr_t)w.get(), PWORKSPACEB->m_name)});
-            g_pEventManager->postEvent(SHyprIPCEvent{"movewindowv2", std::format("{:x},{},{}", (uintptr_t)w.get(), PWORKSPACEB->m_id, PWORKSPACEB->m_name)});
-            Event::bus()->m_events.window.moveToWorkspace.emit(w, PWORKSPACEB);
+    // rescued windows stay restorable, the snapshot now expects them where they are grabbed to
+    for (auto& [SELECTOR, snapshot] : g_monitorSnapshots) {
+        for (auto& e : snapshot.entries) {
+            if (g_workspaceIndex.rogue.contains((uintptr_t)e.window.get()))
+                e.workspace = target->m_id;
         }
     }
 
-    return {};
+    return moveWindowsToWorkspace(rogueWindows, target);
 }
 
 static SDispatchResult grabRogueWindows(std::string args) {
+    CStatsTimer timer(STATS_GRABROGUEWINDOWS);
+
     const auto PWORKSPACE = Desktop::focusState()->monitor()->m_activeWorkspace;
 
     if (!PWORKSPACE) {
@@ -397,57 +955,389 @@ static SDispatchResult grabRogueWindows(std::string args) {
         return {.success = false, .error = "no active workspace?"};
     }
 
+    regroupRogueWindows(PWORKSPACE);
+    return {};
+}
+
+// split:movewindows class:<regex>,<workspace> moves every matching window at once, also initialclass:, title: and initialtitle:
+static SDispatchResult moveWindows(std::string args) {
+    CStatsTimer timer(STATS_MOVEWINDOWS);
+
+    const auto COMMA = args.find_last_of(',');
+    if (COMMA == std::string::npos)
+        return {.success = false, .error = "movewindows: expected <selector>,<workspace>"};
+
+    const auto SELECTOR  = std::string_view{args}.substr(0, COMMA);
+    const auto WORKSPACE = args.substr(COMMA + 1);
+
+    const auto COLON = SELECTOR.find(':');
+    if (COLON == std::string_view::npos)
+        return {.success = false, .error = "movewindows: selector must be class:, initialclass:, title: or initialtitle:"};
+
+    const auto FIELD = SELECTOR.substr(0, COLON);
+    if (FIELD != "class" && FIELD != "initialclass" && FIELD != "title" && FIELD != "initialtitle")
+        return {.success = false, .error = "movewindows: selector must be class:, initialclass:, title: or initialtitle:"};
+
+    std::regex regex;
+    try {
+        regex = std::regex(std::string{SELECTOR.substr(COLON + 1)});
+    } catch (const std::regex_error& e) {
+        return {.success = false, .error = std::format("movewindows: invalid regex: {}", e.what())};
+    }
+
+    const auto PCURRMONITOR = Desktop::focusState()->monitor();
+    if (!PCURRMONITOR)
+        return {.success = false, .error = "movewindows: monitor doesn't exist"};
+
+    const auto RESOLVEDID      = getWorkspaceIDOnCurrentMonitor(WORKSPACE);
+    const auto WORKSPACEIDNAME = RESOLVEDID.has_value() ? SWorkspaceIDName{.id = RESOLVEDID.value(), .name = std::to_string(RESOLVEDID.value())} : getWorkspaceIDNameFromString(WORKSPACE);
+
+    if (WORKSPACEIDNAME.id == WORKSPACE_INVALID)
+        return {.success = false, .error = "movewindows: invalid workspace"};
+
+    std::vector<PHLWINDOW> matching;
     for (auto& w : g_pCompositor->m_windows) {
-        if (!w->m_isMapped || w->onSpecialWorkspace())
+        if (!w->m_isMapped)
             continue;
 
-        bool inGoodWorkspace = false;
+        const auto& VALUE = FIELD == "class" ? w->m_class : FIELD == "initialclass" ? w->m_initialClass : FIELD == "title" ? w->m_title : w->m_initialTitle;
+        if (std::regex_search(VALUE, regex))
+            matching.push_back(w);
+    }
+
+    if (matching.empty())
+        return {};
+
+    auto PWORKSPACE = g_pCompositor->getWorkspaceByID(WORKSPACEIDNAME.id);
+    if (!PWORKSPACE) {
+        const auto PMONITOR = getMonitorForWorkspaceID(WORKSPACEIDNAME.id);
+        PWORKSPACE          = g_pCompositor->createNewWorkspace(WORKSPACEIDNAME.id, (PMONITOR ? PMONITOR : PCURRMONITOR)->m_id, WORKSPACEIDNAME.name);
+    }
 
-        for (auto& m : g_pCompositor->m_monitors) {
-            const auto RANGE = MonitorRange(m);
+    moveWindowsToWorkspace(matching, PWORKSPACE);
+    return {};
+}
+
+static std::string monitorSnapshotKey(const PHLMONITOR& monitor) {
+    return monitor->m_shortDescription.empty() ? monitor->m_name : "desc:" + monitor->m_shortDescription;
+}
 
-            if (RANGE.contains(w->workspaceID())) {
-                inGoodWorkspace = true;
+static void snapshotMonitor(const PHLMONITOR& monitor) {
+    static const auto RESTORE = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:restore_workspaces");
+    if (!*RESTORE || monitor->isMirror())
+        return;
+
+    const auto RANGE = getMonitorRange(monitor);
+    if (RANGE.base < 0)
+        return;
+
+    SMonitorSnapshot snapshot;
+    for (const auto& [ID, WINDOWS] : g_workspaceIndex.windows) {
+        if (!RANGE.contains(ID))
+            continue;
+
+        for (const auto& w : WINDOWS) {
+            if (const auto PWINDOW = w.lock(); PWINDOW && PWINDOW->m_isMapped)
+                snapshot.entries.emplace_back(w, ID, ID - RANGE.min);
+        }
+    }
+
+    hsLog(DEBUG, "snapshot of {}: {} windows", monitor->m_name, snapshot.entries.size());
+
+    if (snapshot.entries.empty())
+        g_monitorSnapshots.erase(monitorSnapshotKey(monitor));
+    else
+        g_monitorSnapshots[monitorSnapshotKey(monitor)] = std::move(snapshot);
+}
+
+// snapshots of monitors that never come back, or come back under another description, are dropped once none of their windows is alive
+static void pruneMonitorSnapshots() {
+    for (auto it = g_monitorSnapshots.begin(); it != g_monitorSnapshots.end();) {
+        std::erase_if(it->second.entries, [](const SMonitorSnapshot::SEntry& e) { return !e.window.lock(); });
+        it = it->second.entries.empty() ? g_monitorSnapshots.erase(it) : std::next(it);
+    }
+}
+
+// runs once hotplug settled so the ranges are final, every window goes back in a single batch per target workspace
+static void restoreMonitorSnapshots() {
+    pruneMonitorSnapshots();
+    if (g_monitorSnapshots.empty())
+        return;
+
+    for (auto it = g_monitorSnapshots.begin(); it != g_monitorSnapshots.end();) {
+        PHLMONITOR monitor;
+        for (const auto& m : g_pCompositor->m_monitors) {
+            if (m && m->m_id != MONITOR_INVALID && !m->isMirror() && m->matchesStaticSelector(it->first)) {
+                monitor = m;
                 break;
             }
         }
 
-        if (!inGoodWorkspace) {
-            hsLog(DEBUG, "moving window {} to workspace {}", w->m_title, PWORKSPACE->m_id);
-            const auto args = std::format("{},address:0x{:x}", PWORKSPACE->m_id, (uintptr_t)w.get());
-            g_pKeybindManager->m_dispatchers["movetoworkspacesilent"](args);
+        if (!monitor) {
+            it++;
+            continue;
+        }
+
+        const auto                                              RANGE = getMonitorRange(monitor);
+        std::unordered_map<WORKSPACEID, std::vector<PHLWINDOW>> targets;
+        for (const auto& e : it->second.entries) {
+            const auto PWINDOW = e.window.lock();
+            if (!PWINDOW || !PWINDOW->m_isMapped || PWINDOW->workspaceID() != e.workspace || e.slot >= RANGE.max - RANGE.min + 1)
+                continue;
+
+            if (RANGE.min + e.slot != e.workspace)
+                targets[RANGE.min + e.slot].emplace_back(PWINDOW);
         }
+
+        size_t restored = 0;
+        for (const auto& [ID, WINDOWS] : targets) {
+            auto PWORKSPACE = g_pCompositor->getWorkspaceByID(ID);
+            if (!PWORKSPACE)
+                PWORKSPACE = g_pCompositor->createNewWorkspace(ID, monitor->m_id);
+
+            restored += moveWindowsToWorkspace(WINDOWS, PWORKSPACE);
+        }
+
+        hsLog(DEBUG, "restored {} windows on {}", restored, monitor->m_name);
+        it = g_monitorSnapshots.erase(it);
     }
-    return {};
+}
+
+// monitor hotplug events come in bursts (e.g. docking), they are coalesced into one reconcile against the final monitor set
+static SP<CEventLoopTimer> g_pHotplugTimer;
+
+static void onHotplugSettled() {
+    CStatsTimer       timer(STATS_HOTPLUGSETTLED);
+
+    static const auto AUTOGRAB = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:auto_grab_rogue");
+
+    hsLog(DEBUG, "hotplug settled, reconciling workspaces");
+
+    invalidateRangeTable();
+    rebuildWorkspaceIndex();
+    restoreMonitorSnapshots();
+    ensureGoodWorkspaces();
+
+    if (!*AUTOGRAB || g_workspaceIndex.rogue.empty())
+        return;
+
+    const auto PMONITOR = Desktop::focusState()->monitor();
+    if (!PMONITOR || !PMONITOR->m_activeWorkspace)
+        return;
+
+    const auto MOVED = regroupRogueWindows(PMONITOR->m_activeWorkspace);
+    hsLog(DEBUG, "auto grabbed {} rogue windows to workspace {}", MOVED, PMONITOR->m_activeWorkspace->m_id);
+}
+
+static void scheduleHotplugReconcile() {
+    static const auto DEBOUNCE = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:hotplug_debounce_ms");
+
+    invalidateRangeTable();
+
+    if (*DEBOUNCE <= 0 || !g_pHotplugTimer) {
+        onHotplugSettled();
+        return;
+    }
+
+    // every event pushes the deadline back
+    g_pHotplugTimer->updateTimeout(std::chrono::milliseconds(*DEBOUNCE));
 }
 
 static void onMonitorAdded(PHLMONITOR pMonitor) {
+    CStatsTimer timer(STATS_MONITORADDED);
+
     hsLog(DEBUG, "monitor added {}", pMonitor->m_name);
 
-    ensureGoodWorkspaces();
+    scheduleHotplugReconcile();
 }
 
 static void onMonitorRemoved(PHLMONITOR pMonitor) {
+    CStatsTimer timer(STATS_MONITORREMOVED);
+
     hsLog(DEBUG, "monitor removed {}", pMonitor->m_name);
 
-    static const auto PERSISTENT = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:persistent_workspaces");
+    snapshotMonitor(pMonitor);
+    if (pMonitor->m_id >= 0 && (size_t)pMonitor->m_id < g_workspaceHistory.size())
+        g_workspaceHistory[pMonitor->m_id] = {};
 
-    if (*PERSISTENT) {
-        const auto RANGE = MonitorRange(pMonitor);
+    // the persistent rules of the removed monitor are dropped by the reconcile once the monitor set settles
+    scheduleHotplugReconcile();
+}
 
-        std::erase_if(Config::workspaceRuleMgr()->m_rules,
-                      [&](Config::CWorkspaceRule const& rule) { return rule.m_layoutopts.contains("hyprsplit") && RANGE.contains(rule.m_workspaceId); });
-        g_pCompositor->ensurePersistentWorkspacesPresent(Config::workspaceRuleMgr()->getAllWorkspaceRules());
+static void updateLogLevel() {
+    static const auto      LOGLEVEL = ConfigValue<Hyprlang::STRING>("plugin:hyprsplit:log_level");
+    const std::string_view LEVEL    = *LOGLEVEL;
+
+    if (LEVEL == "trace")
+        g_hsLogLevel = TRACE;
+    else if (LEVEL == "info")
+        g_hsLogLevel = INFO;
+    else if (LEVEL == "warn")
+        g_hsLogLevel = WARN;
+    else if (LEVEL == "err")
+        g_hsLogLevel = ERR;
+    else
+        g_hsLogLevel = DEBUG;
+}
+
+// the effective hyprsplit config, a reload only reconciles workspaces when it changes
+struct SConfigFingerprint {
+    long                                      numWorkspaces = -1;
+    long                                      forcePriority = 0;
+    long                                      persistent    = 0;
+    std::vector<std::string>                  priorities;
+    std::vector<std::pair<std::string, long>> workspaceCounts;
+
+    bool                                      operator==(const SConfigFingerprint&) const = default;
+};
+
+static SConfigFingerprint g_appliedConfig;
+
+// ranges as they were before a reload or keyword change started, for remapping when workspace counts change
+static struct {
+    SRangeLayout      layout;
+    std::vector<long> baseByMonitor;
+} g_previousRanges;
+
+static void capturePreviousRanges() {
+    const auto& RANGES             = rangeTable();
+    g_previousRanges.layout        = RANGES.layout;
+    g_previousRanges.baseByMonitor = RANGES.baseByMonitor;
+}
+
+static SConfigFingerprint currentConfigFingerprint() {
+    static const auto NUMWORKSPACES = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:num_workspaces");
+    static const auto FORCEPRIORITY = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:force_monitor_priority");
+    static const auto PERSISTENT    = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:persistent_workspaces");
+
+    return {.numWorkspaces = *NUMWORKSPACES, .forcePriority = *FORCEPRIORITY, .persistent = *PERSISTENT, .priorities = g_monitorPriorities, .workspaceCounts = g_monitorWorkspaceCounts};
+}
+
+// moves every window to the same slot of its monitor's new range in one planned pass, then puts each monitor on its remapped
+// active workspace. targets are computed before anything moves so chains like 11 -> 6 while 6 -> 5 don't interfere
+static void remapWorkspaces(const SRangeLayout& oldLayout, const std::vector<long>& oldBaseByMonitor) {
+    SRangeRemap remap = {.oldLayout = oldLayout, .newLayout = rangeTable().layout};
+    for (size_t id = 0; id < oldBaseByMonitor.size(); id++) {
+        const auto OLDBASE  = oldBaseByMonitor[id];
+        const auto PMONITOR = g_pCompositor->getMonitorFromID(id);
+        if (OLDBASE < 0 || !PMONITOR)
+            continue;
+
+        if ((size_t)OLDBASE >= remap.newBaseByOldBase.size())
+            remap.newBaseByOldBase.resize(OLDBASE + 1, -1);
+        remap.newBaseByOldBase[OLDBASE] = getMonitorBase(PMONITOR);
     }
+
+    std::unordered_map<WORKSPACEID, std::vector<PHLWINDOW>> targets;
+    for (const auto& [ID, WINDOWS] : g_workspaceIndex.windows) {
+        const auto TARGET = remapWorkspaceID(remap, ID);
+        if (!TARGET.has_value() || TARGET.value() == ID)
+            continue;
+
+        auto& list = targets[TARGET.value()];
+        for (const auto& w : WINDOWS) {
+            if (const auto PWINDOW = w.lock())
+                list.emplace_back(PWINDOW);
+        }
+    }
+
+    std::vector<std::pair<PHLMONITOR, WORKSPACEID>> actives;
+    for (const auto& m : g_pCompositor->m_monitors) {
+        if (!m || m->m_id == MONITOR_INVALID || m->isMirror())
+            continue;
+
+        const auto TARGET = remapWorkspaceID(remap, m->activeWorkspaceID());
+        if (TARGET.has_value() && TARGET.value() != m->activeWorkspaceID())
+            actives.emplace_back(m, TARGET.value());
+    }
+
+    const auto getOrCreate = [](WORKSPACEID id) {
+        auto PWORKSPACE = g_pCompositor->getWorkspaceByID(id);
+        if (!PWORKSPACE) {
+            const auto PMONITOR = getMonitorForWorkspaceID(id);
+            PWORKSPACE          = g_pCompositor->createNewWorkspace(id, (PMONITOR ? PMONITOR : Desktop::focusState()->monitor())->m_id);
+        }
+        return PWORKSPACE;
+    };
+
+    size_t moved = 0;
+    for (const auto& [ID, WINDOWS] : targets) {
+        moved += moveWindowsToWorkspace(WINDOWS, getOrCreate(ID));
+    }
+
+    for (const auto& [MONITOR, ID] : actives) {
+        const auto PWORKSPACE = getOrCreate(ID);
+        if (PWORKSPACE->monitorID() != MONITOR->m_id)
+            moveWorkspaceToMonitor(PWORKSPACE, MONITOR);
+        changeWorkspace(MONITOR, PWORKSPACE);
+    }
+
+    hsLog(DEBUG, "workspace counts changed, remapped {} windows to {} workspaces", moved, targets.size());
+}
+
+// reconciles workspaces against a changed hyprsplit config. when workspace counts changed every window keeps its slot, remapped from
+// the ranges captured before the change
+static void applyConfigChange(const SConfigFingerprint& config) {
+    const bool REMAP = g_appliedConfig.numWorkspaces > 0 && !g_previousRanges.layout.starts.empty() &&
+        (g_appliedConfig.numWorkspaces != config.numWorkspaces || g_appliedConfig.workspaceCounts != config.workspaceCounts);
+    g_appliedConfig = config;
+
+    invalidateRangeTable();
+    rebuildWorkspaceIndex();
+    if (REMAP)
+        remapWorkspaces(g_previousRanges.layout, g_previousRanges.baseByMonitor);
+    ensureGoodWorkspaces();
+}
+
+// set between preReload and reloaded, keyword changes are left to the reload then
+static bool g_configReloading = false;
+
+// hyprctl keyword changes hyprsplit values without a reload. they are applied from the event loop once the request returned, a burst
+// of keywords is applied once against the ranges from before its first change
+static SP<CEventLoopTimer> g_pKeywordTimer;
+static bool                g_keywordChangePending = false;
+
+static void onKeywordChangeSettled() {
+    g_keywordChangePending = false;
+
+    updateLogLevel();
+
+    const auto CONFIG = currentConfigFingerprint();
+    if (g_configReloading || CONFIG == g_appliedConfig)
+        return;
+
+    hsLog(DEBUG, "hyprsplit config changed by keyword, reconciling workspaces");
+    applyConfigChange(CONFIG);
 }
 
 static void onConfigReloaded() {
+    CStatsTimer timer(STATS_CONFIGRELOADED);
+
+    g_configReloading = false;
+
+    updateLogLevel();
     clearHyprSplitVersionEnv();
-    ensureGoodWorkspaces();
+
+    const auto CONFIG = currentConfigFingerprint();
+    if (CONFIG == g_appliedConfig) {
+        hsLog(DEBUG, "hyprsplit config unchanged, skipping reconcile");
+
+        // hyprland drops every workspace rule on reload, ours have to come back
+        reconcilePersistence();
+        return;
+    }
+
+    applyConfigChange(CONFIG);
 }
 
 static void onConfigPreReloaded() {
+    // config values still hold the old settings here
+    capturePreviousRanges();
+    g_configReloading = true;
+
     g_monitorPriorities.clear();
+    g_monitorWorkspaceCounts.clear();
+    g_workspaceArgCache.clear();
     exportHyprSplitVersionEnv();
 }
 
@@ -459,42 +1349,289 @@ static Hyprlang::CParseResult configHandleMonitorPriority(const char* command, c
         g_monitorPriorities.emplace_back(arg);
     }
 
+    invalidateRangeTable();
+
     Hyprlang::CParseResult result;
     return result;
 }
 
+// monitor_workspaces = <selector>, <count>
+static Hyprlang::CParseResult configHandleMonitorWorkspaces(const char* command, const char* args) {
+    const auto             ARGS  = CVarList2(args);
+    const auto             COUNT = parseSignedNumber(ARGS[1]);
+
+    Hyprlang::CParseResult result;
+    if (ARGS[0].empty() || !COUNT.has_value() || COUNT.value() < 1) {
+        result.setError("monitor_workspaces: expected <monitor>, <number of workspaces>");
+        return result;
+    }
+
+    hsLog(DEBUG, "monitor workspaces: {} -> {}", ARGS[0], COUNT.value());
+    g_monitorWorkspaceCounts.emplace_back(std::string{ARGS[0]}, COUNT.value());
+
+    invalidateRangeTable();
+    return result;
+}
+
+// every workspace in every monitor range, including ones that don't exist yet
+static std::string workspacesToJSON() {
+    std::string result = "[";
+    auto        out    = std::back_inserter(result);
+    bool        first  = true;
+
+    for (const auto& m : g_pCompositor->m_monitors) {
+        if (!m || m->m_id == MONITOR_INVALID || m->isMirror())
+            continue;
+
+        const auto RANGE = getMonitorRange(m);
+        for (auto id = RANGE.min; id <= RANGE.max; id++) {
+            const auto WINDOWS = g_workspaceIndex.mappedCount.find(id);
+            std::format_to(out, "{}{{\"id\": {}, \"monitor\": \"{}\", \"exists\": {}, \"active\": {}, \"windows\": {}}}", first ? "" : ", ", id, m->m_name,
+                           std::ranges::binary_search(g_workspaceIndex.occupancy.live, id), m->activeWorkspaceID() == id,
+                           WINDOWS == g_workspaceIndex.mappedCount.end() ? 0 : WINDOWS->second);
+            first = false;
+        }
+    }
+
+    result += "]";
+    return result;
+}
+
+// hyprctl hyprsplit stats [reset] | workspaces | trace start|stop|dump [path]
+static std::string hyprctlHyprsplit(eHyprCtlOutputFormat format, std::string request) {
+    const auto ARGS = CVarList2(std::move(request), 0, ' ');
+
+    if (ARGS[1] == "stats") {
+        if (ARGS[2] == "reset") {
+            statsReset();
+            return "ok";
+        }
+
+        return statsToJSON();
+    }
+
+    if (ARGS[1] == "workspaces")
+        return workspacesToJSON();
+
+    if (ARGS[1] == "trace") {
+        if (ARGS[2] == "start") {
+            traceStart();
+            return "ok";
+        }
+        if (ARGS[2] == "stop") {
+            traceStop();
+            return std::format("ok, {} events buffered", traceSize());
+        }
+        if (ARGS[2] == "dump") {
+            const std::string PATH  = ARGS[3].empty() ? "/tmp/hyprsplit-trace.json" : std::string{ARGS[3]};
+            const auto        ERROR = traceDump(PATH);
+            return ERROR.empty() ? std::format("wrote {} events to {}", traceSize(), PATH) : ERROR;
+        }
+    }
+
+    return "usage: hyprctl hyprsplit stats [reset] | workspaces | trace start|stop|dump [path]";
+}
+
+// the workspace the swipe will move to, created at swipe begin so hyprland doesn't create and lay it out during the first update
+// frame. removed again at swipe end unless the swipe landed on it
+static PHLWORKSPACEREF g_prewarmedWorkspace;
+
+static void prewarmSwipeNeighbour(const PHLMONITOR& m, const MonitorRange& range, int dir) {
+    static auto PSWIPEUSER = ConfigValue<Hyprlang::INT>("gestures:workspace_swipe_use_r");
+
+    WORKSPACEID target = m->activeWorkspaceID() + dir;
+    if (!*PSWIPEUSER) {
+        // the swipe skips to the next existing workspace (e style), same lookup as split:workspace e+1 on the cached live set.
+        // only when there is none does hyprland create the adjacent one
+        const auto EXISTING = resolveWorkspaceArg(SWorkspaceArg{WSARG_RELATIVE_OPEN, dir}, range, m->activeWorkspaceID(), g_workspaceIndex.occupancy);
+        if (EXISTING.has_value() && EXISTING.value() != m->activeWorkspaceID())
+            return;
+    }
+
+    if (!range.contains(target) || g_pCompositor->getWorkspaceByID(target))
+        return;
+
+    hsLog(DEBUG, "prewarming workspace {} for swipe", target);
+    g_prewarmedWorkspace = g_pCompositor->createNewWorkspace(target, m->m_id);
+}
+
+static void releasePrewarmedWorkspace() {
+    const auto PWORKSPACE = g_prewarmedWorkspace.lock();
+    g_prewarmedWorkspace.reset();
+
+    if (!PWORKSPACE || PWORKSPACE->isVisible() || PWORKSPACE->getWindows() > 0)
+        return;
+
+    hsLog(DEBUG, "swipe did not land on prewarmed workspace {}, removing it", PWORKSPACE->m_id);
+
+    if (std::ranges::binary_search(g_lazyPersistentWorkspaces, PWORKSPACE->m_id)) {
+        PWORKSPACE->setPersistent(false);
+        sortedErase(g_lazyPersistentWorkspaces, PWORKSPACE->m_id);
+    }
+
+    g_pCompositor->sanityCheckWorkspaces();
+}
+
 static inline CFunctionHook* g_pWorkspaceSwipeGestureBeginHook = nullptr;
 typedef void (*origWorkspaceSwipeGestureBegin)(void*, const ITrackpadGesture::STrackpadGestureBegin& e);
 static void hkWorkspaceSwipeGestureBegin(void* thisptr, const ITrackpadGesture::STrackpadGestureBegin& e) {
     hsLog(DEBUG, "hook workspace swipe begin");
 
-    // partial taken from CWorkspaceSwipeGesture::update
-    static auto PSWIPEINVR = ConfigValue<Hyprlang::INT>("gestures:workspace_swipe_invert");
-    int         dir        = e.direction == TRACKPAD_GESTURE_DIR_LEFT ? -1 : 1;
-    if (*PSWIPEINVR)
-        dir = -dir;
+    {
+        CStatsTimer timer(STATS_SWIPEBEGIN);
 
-    auto       m     = Desktop::focusState()->monitor();
-    const auto RANGE = MonitorRange(m);
+        // partial taken from CWorkspaceSwipeGesture::update
+        static auto PSWIPEINVR = ConfigValue<Hyprlang::INT>("gestures:workspace_swipe_invert");
+        int         dir        = e.direction == TRACKPAD_GESTURE_DIR_LEFT ? -1 : 1;
+        if (*PSWIPEINVR)
+            dir = -dir;
 
-    if (m->activeWorkspaceID() == RANGE.max && dir > 0) {
-        hsLog(DEBUG, "blocking workspace swipe begin to right on ws {}", m->activeWorkspaceID());
-        return;
-    }
-    if (m->activeWorkspaceID() == RANGE.min && dir < 0) {
-        hsLog(DEBUG, "blocking workspace swipe begin to left on ws {}", m->activeWorkspaceID());
-        return;
+        auto       m     = Desktop::focusState()->monitor();
+        const auto RANGE = getMonitorRange(m);
+
+        if (m->activeWorkspaceID() == RANGE.max && dir > 0) {
+            hsLog(DEBUG, "blocking workspace swipe begin to right on ws {}", m->activeWorkspaceID());
+            return;
+        }
+        if (m->activeWorkspaceID() == RANGE.min && dir < 0) {
+            hsLog(DEBUG, "blocking workspace swipe begin to left on ws {}", m->activeWorkspaceID());
+            return;
+        }
+
+        static const auto PREWARM = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:swipe_prewarm");
+        if (*PREWARM)
+            prewarmSwipeNeighbour(m, RANGE, dir);
     }
 
     hsLog(DEBUG, "calling original workspace swipe begin");
     return (*(origWorkspaceSwipeGestureBegin)g_pWorkspaceSwipeGestureBeginHook->m_original)(thisptr, e);
 }
 
+static inline CFunctionHook* g_pWorkspaceSwipeGestureEndHook = nullptr;
+typedef void (*origWorkspaceSwipeGestureEnd)(void*, const ITrackpadGesture::STrackpadGestureEnd& e);
+static void hkWorkspaceSwipeGestureEnd(void* thisptr, const ITrackpadGesture::STrackpadGestureEnd& e) {
+    (*(origWorkspaceSwipeGestureEnd)g_pWorkspaceSwipeGestureEndHook->m_original)(thisptr, e);
+
+    // the swipe has switched workspaces or snapped back by now
+    releasePrewarmedWorkspace();
+}
+
+// hyprland parses every workspace string through this, including window rule targets before the window is first mapped. a
+// `split:` prefix resolves the rest on the focused monitor like split:workspace does, so `windowrule = workspace split:3` lays the
+// window out once on the right workspace instead of needing a split:movetoworkspacesilent after it maps
+static inline CFunctionHook* g_pGetWorkspaceIDNameFromStringHook = nullptr;
+typedef SWorkspaceIDName (*origGetWorkspaceIDNameFromString)(const std::string&);
+static SWorkspaceIDName hkGetWorkspaceIDNameFromString(const std::string& in) {
+    const auto ORIGINAL = (origGetWorkspaceIDNameFromString)g_pGetWorkspaceIDNameFromStringHook->m_original;
+
+    if (!in.starts_with("split:"))
+        return ORIGINAL(in);
+
+    CStatsTimer timer(STATS_LOCALWORKSPACE);
+
+    const auto  WORKSPACE  = std::string_view{in}.substr(6);
+    const auto  RESOLVEDID = getWorkspaceIDOnCurrentMonitor(WORKSPACE);
+    if (!RESOLVEDID.has_value())
+        return ORIGINAL(std::string{WORKSPACE});
+
+    hsLog(DEBUG, "resolved {} to workspace {}", in, RESOLVEDID.value());
+    return {.id = RESOLVEDID.value(), .name = std::to_string(RESOLVEDID.value())};
+}
+
+// hyprctl keyword goes through here. the ranges are captured before the first hyprsplit value of a burst changes and the reconcile is
+// left to g_pKeywordTimer, so nothing moves while hyprland is still handling the request
+static inline CFunctionHook* g_pParseKeywordHook = nullptr;
+typedef std::string (*origParseKeyword)(void*, const std::string&, const std::string&);
+static std::string hkParseKeyword(void* thisptr, const std::string& command, const std::string& value) {
+    const bool TRACKED = !g_configReloading && !g_keywordChangePending && command.starts_with("plugin:hyprsplit:");
+    if (TRACKED)
+        capturePreviousRanges();
+
+    auto result = (*(origParseKeyword)g_pParseKeywordHook->m_original)(thisptr, command, value);
+
+    if (TRACKED && g_pKeywordTimer) {
+        g_keywordChangePending = true;
+        g_pKeywordTimer->updateTimeout(std::chrono::milliseconds(1));
+    }
+
+    return result;
+}
+
 // other plugins can use this to convert a regular hyprland workspace string the correct hyprsplit one
 APICALL EXPORT std::string hyprsplitGetWorkspace(const std::string& workspace) {
     return getWorkspaceOnCurrentMonitor(workspace);
 }
 
+static_assert(HYPRSPLIT_WS_ABSOLUTE == WSARG_ABSOLUTE && HYPRSPLIT_WS_RELATIVE == WSARG_RELATIVE && HYPRSPLIT_WS_RELATIVE_WRAP == WSARG_RELATIVE_WRAP &&
+              HYPRSPLIT_WS_RELATIVE_OPEN == WSARG_RELATIVE_OPEN && HYPRSPLIT_WS_RELATIVE_LOOP == WSARG_RELATIVE_LOOP && HYPRSPLIT_WS_EMPTY == WSARG_EMPTY);
+
+static PHLMONITOR getAbiMonitor(int64_t monitor) {
+    const auto PMONITOR = monitor < 0 ? Desktop::focusState()->monitor() : g_pCompositor->getMonitorFromID(monitor);
+    if (!PMONITOR || PMONITOR->m_id == MONITOR_INVALID || PMONITOR->isMirror())
+        return nullptr;
+    return PMONITOR;
+}
+
+// integer versions of the above, see hyprsplit.h
+APICALL EXPORT int32_t hyprsplitAbiVersion() {
+    return HYPRSPLIT_ABI_VERSION;
+}
+
+APICALL EXPORT int32_t hyprsplitGetMonitorRange(int64_t monitor, int64_t* min, int64_t* max) {
+    const auto PMONITOR = getAbiMonitor(monitor);
+    if (!PMONITOR)
+        return 0;
+
+    const auto RANGE = getMonitorRange(PMONITOR);
+    if (RANGE.base < 0)
+        return 0;
+
+    if (min)
+        *min = RANGE.min;
+    if (max)
+        *max = RANGE.max;
+    return 1;
+}
+
+APICALL EXPORT int64_t hyprsplitSlotToWorkspaceID(int64_t monitor, int64_t slot) {
+    const auto PMONITOR = getAbiMonitor(monitor);
+    if (!PMONITOR)
+        return -1;
+
+    const auto RANGE = getMonitorRange(PMONITOR);
+    if (RANGE.base < 0 || slot < 1 || slot > RANGE.max - RANGE.min + 1)
+        return -1;
+
+    return RANGE.min + slot - 1;
+}
+
+APICALL EXPORT int64_t hyprsplitResolveWorkspace(int64_t monitor, int32_t kind, int64_t value) {
+    const auto PMONITOR = getAbiMonitor(monitor);
+    if (!PMONITOR || kind < HYPRSPLIT_WS_ABSOLUTE || kind > HYPRSPLIT_WS_EMPTY)
+        return -1;
+
+    const auto RANGE = getMonitorRange(PMONITOR);
+    if (RANGE.base < 0)
+        return -1;
+
+    const auto RESULT = resolveWorkspaceArg(SWorkspaceArg{(eWorkspaceArgKind)kind, value}, RANGE, PMONITOR->activeWorkspaceID(), g_workspaceIndex.occupancy);
+    return RESULT.value_or(-1);
+}
+
+APICALL EXPORT int32_t hyprsplitWorkspaceInRange(int64_t monitor, int64_t workspace) {
+    const auto PMONITOR = getAbiMonitor(monitor);
+    if (!PMONITOR)
+        return 0;
+
+    const auto RANGE = getMonitorRange(PMONITOR);
+    return RANGE.base >= 0 && RANGE.contains(workspace);
+}
+
+APICALL EXPORT int64_t hyprsplitGetMonitorForWorkspace(int64_t workspace) {
+    const auto PMONITOR = getMonitorForWorkspaceID(workspace);
+    return PMONITOR ? PMONITOR->m_id : -1;
+}
+
 // Do NOT change this function.
 APICALL EXPORT std::string PLUGIN_API_VERSION() {
     return HYPRLAND_API_VERSION;
@@ -519,19 +1656,66 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:num_workspaces", Hyprlang::INT{10});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:persistent_workspaces", Hyprlang::INT{0});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:force_monitor_priority", Hyprlang::INT{0});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:coalesce_swap_events", Hyprlang::INT{0});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:log_level", Hyprlang::STRING{"debug"});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:auto_grab_rogue", Hyprlang::INT{0});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:restore_workspaces", Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:swipe_prewarm", Hyprlang::INT{0});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprsplit:hotplug_debounce_ms", Hyprlang::INT{50});
 
     HyprlandAPI::addConfigKeyword(PHANDLE, "plugin:hyprsplit:monitor_priority", configHandleMonitorPriority, (Hyprlang::SHandlerOptions){.allowFlags = false});
+    HyprlandAPI::addConfigKeyword(PHANDLE, "plugin:hyprsplit:monitor_workspaces", configHandleMonitorWorkspaces, (Hyprlang::SHandlerOptions){.allowFlags = false});
+
+    g_dispatchers.workspace             = resolveDispatcher("workspace");
+    g_dispatchers.moveToWorkspace       = resolveDispatcher("movetoworkspace");
+    g_dispatchers.moveToWorkspaceSilent = resolveDispatcher("movetoworkspacesilent");
+    if (!g_dispatchers.workspace || !g_dispatchers.moveToWorkspace || !g_dispatchers.moveToWorkspaceSilent) {
+        HyprlandAPI::addNotification(PHANDLE, "[hyprsplit] Failure in initialization: missing hyprland dispatchers", CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        throw std::runtime_error("[hyprsplit] Missing dispatchers");
+    }
 
     HyprlandAPI::addDispatcherV2(PHANDLE, "split:workspace", focusWorkspace);
     HyprlandAPI::addDispatcherV2(PHANDLE, "split:movetoworkspace", moveToWorkspace);
     HyprlandAPI::addDispatcherV2(PHANDLE, "split:movetoworkspacesilent", moveToWorkspaceSilent);
     HyprlandAPI::addDispatcherV2(PHANDLE, "split:swapactiveworkspaces", swapActiveWorkspaces);
+    HyprlandAPI::addDispatcherV2(PHANDLE, "split:rotateactiveworkspaces", rotateActiveWorkspaces);
+    HyprlandAPI::addDispatcherV2(PHANDLE, "split:swapmonitors", swapMonitors);
     HyprlandAPI::addDispatcherV2(PHANDLE, "split:grabroguewindows", grabRogueWindows);
+    HyprlandAPI::addDispatcherV2(PHANDLE, "split:movewindows", moveWindows);
+
+    g_pHotplugTimer = makeShared<CEventLoopTimer>(std::nullopt, [](SP<CEventLoopTimer> self, void* data) { onHotplugSettled(); }, nullptr);
+    g_pEventLoopManager->addTimer(g_pHotplugTimer);
+    g_pKeywordTimer = makeShared<CEventLoopTimer>(std::nullopt, [](SP<CEventLoopTimer> self, void* data) { onKeywordChangeSettled(); }, nullptr);
+    g_pEventLoopManager->addTimer(g_pKeywordTimer);
+
+    HyprlandAPI::registerHyprCtlCommand(PHANDLE, SHyprCtlCommand{.name = "hyprsplit", .exact = false, .fn = hyprctlHyprsplit});
 
     static auto       monitorAddedListener      = Event::bus()->m_events.monitor.added.listen([&](PHLMONITOR m) { onMonitorAdded(m); });
     static auto       monitorRemovedListener    = Event::bus()->m_events.monitor.removed.listen([&](PHLMONITOR m) { onMonitorRemoved(m); });
     static auto       configReloadedListener    = Event::bus()->m_events.config.reloaded.listen([&] { onConfigReloaded(); });
     static auto       configPreReloadedListener = Event::bus()->m_events.config.preReload.listen([&] { onConfigPreReloaded(); });
+    static auto       windowOpenListener        = Event::bus()->m_events.window.open.listen([&](PHLWINDOW w) { indexAddWindow(w, w->workspaceID(), true); });
+    static auto       windowCloseListener       = Event::bus()->m_events.window.close.listen([&](PHLWINDOW w) {
+        indexUnmapWindow(w);
+        pruneMonitorSnapshots();
+    });
+    static auto       windowMoveListener        = Event::bus()->m_events.window.moveToWorkspace.listen([&](PHLWINDOW w, PHLWORKSPACE ws) {
+        indexAddWindow(w, ws ? ws->m_id : WORKSPACE_INVALID, w->m_isMapped);
+    });
+    static auto       workspaceCreatedListener  = Event::bus()->m_events.workspace.created.listen([&](PHLWORKSPACE ws) {
+        static const auto PERSISTENT = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:persistent_workspaces");
+
+        if (!ws->m_isSpecialWorkspace)
+            sortedInsert(g_workspaceIndex.occupancy.live, ws->m_id);
+        if (*PERSISTENT == PERSISTENT_LAZY)
+            markLazyPersistent(ws);
+    });
+    static auto       workspaceRemovedListener  = Event::bus()->m_events.workspace.removed.listen([&](PHLWORKSPACEREF) { indexPruneWorkspaces(); });
+    static auto       workspaceActiveListener   = Event::bus()->m_events.workspace.active.listen([&](PHLWORKSPACE ws) { recordActiveWorkspace(ws); });
+
+    for (const auto& m : g_pCompositor->m_monitors) {
+        recordActiveWorkspace(m->m_activeWorkspace);
+    }
 
     static const auto foundBeginFunctions = HyprlandAPI::findFunctionsByName(PHANDLE, "begin");
     for (auto& fun : foundBeginFunctions) {
@@ -542,6 +1726,35 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
         }
     }
 
+    static const auto foundParseFunctions = HyprlandAPI::findFunctionsByName(PHANDLE, "getWorkspaceIDNameFromString");
+    for (auto& fun : foundParseFunctions) {
+        if (fun.demangled.starts_with("getWorkspaceIDNameFromString(")) {
+            g_pGetWorkspaceIDNameFromStringHook = HyprlandAPI::createFunctionHook(PHANDLE, fun.address, (void*)&hkGetWorkspaceIDNameFromString);
+            if (g_pGetWorkspaceIDNameFromStringHook != nullptr && g_pGetWorkspaceIDNameFromStringHook->hook())
+                hsLog(DEBUG, "hooked getWorkspaceIDNameFromString", fun.signature);
+            break;
+        }
+    }
+
+    static const auto foundKeywordFunctions = HyprlandAPI::findFunctionsByName(PHANDLE, "parseKeyword");
+    for (auto& fun : foundKeywordFunctions) {
+        if (fun.demangled.contains("ConfigManager::parseKeyword(")) {
+            g_pParseKeywordHook = HyprlandAPI::createFunctionHook(PHANDLE, fun.address, (void*)&hkParseKeyword);
+            if (g_pParseKeywordHook != nullptr && g_pParseKeywordHook->hook())
+                hsLog(DEBUG, "hooked parseKeyword", fun.signature);
+            break;
+        }
+    }
+
+    static const auto foundEndFunctions = HyprlandAPI::findFunctionsByName(PHANDLE, "end");
+    for (auto& fun : foundEndFunctions) {
+        if (fun.signature.find("CWorkspaceSwipeGesture::end") != std::string::npos) {
+            g_pWorkspaceSwipeGestureEndHook = HyprlandAPI::createFunctionHook(PHANDLE, fun.address, (void*)&hkWorkspaceSwipeGestureEnd);
+            if (g_pWorkspaceSwipeGestureEndHook != nullptr && g_pWorkspaceSwipeGestureEndHook->hook())
+                hsLog(DEBUG, "hooked CWorkspaceSwipeGesture::end", fun.signature);
+        }
+    }
+
     HyprlandAPI::reloadConfig();
 
     hsLog(DEBUG, "plugin init");
@@ -551,6 +1764,17 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
 APICALL EXPORT void PLUGIN_EXIT() {
     hsLog(DEBUG, "plugin exit");
 
+    if (g_pHotplugTimer) {
+        g_pEventLoopManager->removeTimer(g_pHotplugTimer);
+        g_pHotplugTimer.reset();
+    }
+    if (g_pKeywordTimer) {
+        g_pEventLoopManager->removeTimer(g_pKeywordTimer);
+        g_pKeywordTimer.reset();
+    }
+
+    clearLazyPersistentWorkspaces();
+
     static const auto PERSISTENT = ConfigValue<Hyprlang::INT>("plugin:hyprsplit:persistent_workspaces");
     if (*PERSISTENT) {
         std::erase_if(Config::workspaceRuleMgr()->m_rules, [](Config::CWorkspaceRule const& rule) { return rule.m_layoutopts.contains("hyprsplit"); });
@@ -0,0 +1,277 @@
+#include "split.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+void assignMonitorBases(std::vector<SMonitorDesc>& monitors, bool priorityMode, size_t numPriorities) {
+    if (!priorityMode) {
+        for (auto& m : monitors) {
+            m.base = m.id;
+        }
+        return;
+    }
+
+    std::vector<SMonitorDesc*> unmappedMonitors;
+    for (auto& m : monitors) {
+        m.base = m.priority;
+
+        if (m.priority == -1 && m.id != -1 && !m.mirror)
+            unmappedMonitors.push_back(&m);
+    }
+
+    // sort into alphabetical order by name
+    std::ranges::sort(unmappedMonitors, [](const auto& a, const auto& b) -> bool { return a->name < b->name; });
+
+    for (size_t i = 0; i < unmappedMonitors.size(); i++) {
+        unmappedMonitors[i]->base = i + numPriorities;
+    }
+}
+
+void buildRangeLayout(SRangeLayout& layout, const std::vector<long>& counts, long defaultCount) {
+    layout.defaultCount = std::max(defaultCount, 1L);
+    layout.starts.resize(counts.size() + 1);
+    layout.starts[0] = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        layout.starts[i + 1] = layout.starts[i] + std::max(counts[i], 1L);
+    }
+}
+
+MonitorRange rangeForBase(const SRangeLayout& layout, long base) {
+    const long BASES = layout.starts.empty() ? 0 : (long)layout.starts.size() - 1;
+    const long END   = layout.starts.empty() ? 0 : layout.starts.back();
+
+    if (base < 0)
+        return MonitorRange(base, 0, -1);
+
+    if (base < BASES)
+        return MonitorRange(base, layout.starts[base] + 1, layout.starts[base + 1]);
+
+    const long MIN = END + ((base - BASES) * layout.defaultCount) + 1;
+    return MonitorRange(base, MIN, MIN + layout.defaultCount - 1);
+}
+
+long baseForWorkspaceID(const SRangeLayout& layout, long id) {
+    if (id < 1)
+        return -1;
+
+    const long BASES = layout.starts.empty() ? 0 : (long)layout.starts.size() - 1;
+    const long END   = layout.starts.empty() ? 0 : layout.starts.back();
+
+    if (id > END)
+        return BASES + ((id - END - 1) / layout.defaultCount);
+
+    // first start that is >= id, the base before it owns the id
+    return (std::ranges::lower_bound(layout.starts, id) - layout.starts.begin()) - 1;
+}
+
+void sortedInsert(std::vector<long>& v, long id) {
+    const auto IT = std::ranges::lower_bound(v, id);
+    if (IT == v.end() || *IT != id)
+        v.insert(IT, id);
+}
+
+void sortedErase(std::vector<long>& v, long id) {
+    const auto IT = std::ranges::lower_bound(v, id);
+    if (IT != v.end() && *IT == id)
+        v.erase(IT);
+}
+
+std::optional<long> findEmptyWorkspace(const std::vector<long>& occupied, long min, long max) {
+    long candidate = min;
+    for (auto it = std::ranges::lower_bound(occupied, min); it != occupied.end() && *it == candidate && candidate <= max; it++) {
+        candidate++;
+    }
+
+    if (candidate > max)
+        return std::nullopt;
+
+    return candidate;
+}
+
+std::optional<long> parseSignedNumber(std::string_view str) {
+    bool negative = false;
+    if (!str.empty() && (str[0] == '+' || str[0] == '-')) {
+        negative = str[0] == '-';
+        str.remove_prefix(1);
+    }
+
+    long       value     = 0;
+    const auto [PTR, EC] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (str.empty() || EC != std::errc() || PTR != str.data() + str.size())
+        return std::nullopt;
+
+    return negative ? -value : value;
+}
+
+SWorkspaceArg parseWorkspaceArg(std::string_view workspace) {
+    if (workspace.empty())
+        return {};
+
+    if (workspace[0] == '+' || workspace[0] == '-') {
+        const auto VALUE = parseSignedNumber(workspace);
+        return VALUE.has_value() ? SWorkspaceArg{WSARG_RELATIVE, VALUE.value()} : SWorkspaceArg{};
+    }
+
+    if (std::isdigit((unsigned char)workspace[0])) {
+        const auto VALUE = parseSignedNumber(workspace);
+        return VALUE.has_value() ? SWorkspaceArg{WSARG_ABSOLUTE, VALUE.value()} : SWorkspaceArg{};
+    }
+
+    if (workspace.size() > 2 && (workspace[1] == '-' || workspace[1] == '+') && std::isdigit((unsigned char)workspace[2])) {
+        const auto VALUE = parseSignedNumber(workspace.substr(1));
+        if (!VALUE.has_value())
+            return {};
+
+        switch (workspace[0]) {
+            case 'r': return {WSARG_RELATIVE_WRAP, VALUE.value()};
+            case 'e': return {WSARG_RELATIVE_OPEN, VALUE.value()};
+            case 'm': return {WSARG_RELATIVE_LOOP, VALUE.value()};
+            default: return {};
+        }
+    }
+
+    if (workspace.starts_with("empty"))
+        return {WSARG_EMPTY, 0};
+
+    if (workspace == "previous" || workspace == "previous_per_monitor")
+        return {WSARG_PREVIOUS, 0};
+
+    return {};
+}
+
+const SWorkspaceArg& getCachedWorkspaceArg(CWorkspaceArgCache& cache, std::string_view workspace) {
+    const auto IT = cache.find(workspace);
+    if (IT != cache.end())
+        return IT->second;
+
+    // args from hyprctl dispatch can be arbitrary, don't let the cache grow without bound
+    if (cache.size() >= 256)
+        cache.clear();
+
+    return cache.emplace(workspace, parseWorkspaceArg(workspace)).first->second;
+}
+
+std::optional<long> resolveWorkspaceArg(const SWorkspaceArg& arg, const MonitorRange& range, long activeID, const SOccupancy& occupancy) {
+    const long N    = range.size();
+    long       wsID = 1;
+
+    if (N < 1)
+        return std::nullopt;
+
+    switch (arg.kind) {
+        case WSARG_PASSTHROUGH: return std::nullopt;
+        case WSARG_ABSOLUTE: wsID = std::max(arg.value, 1L); break;
+        case WSARG_RELATIVE: wsID = std::clamp(activeID - range.min + 1 + arg.value, 1L, std::max(N, 1L)); break;
+        case WSARG_RELATIVE_WRAP:
+            wsID = activeID - range.min + 1 + arg.value;
+            if (wsID <= 0)
+                wsID = ((((wsID - 1) % N) + N) % N) + 1;
+            break;
+        case WSARG_RELATIVE_OPEN: {
+            const auto& live  = occupancy.live;
+            const auto  FIRST = std::ranges::lower_bound(live, range.min);
+            const auto  LAST  = std::ranges::upper_bound(live, range.max);
+
+            const auto  FINDRESULT = std::ranges::lower_bound(FIRST, LAST, activeID);
+            if (FINDRESULT == LAST || *FINDRESULT != activeID)
+                return std::nullopt;
+
+            const long current     = FINDRESULT - FIRST;
+            const long resultIndex = std::clamp(current + arg.value, 0L, (long)(LAST - FIRST) - 1);
+
+            return *(FIRST + resultIndex);
+        }
+        case WSARG_RELATIVE_LOOP: {
+            const auto& occupied = occupancy.occupied;
+            const auto  FIRST    = std::ranges::lower_bound(occupied, range.min);
+            const auto  LAST     = std::ranges::upper_bound(occupied, range.max);
+            const long  COUNT    = LAST - FIRST;
+
+            if (COUNT == 0 || arg.value == 0)
+                return activeID;
+
+            // when the active workspace is empty it sits between two occupied ones, the first step lands on its neighbour
+            const auto POS    = std::ranges::lower_bound(FIRST, LAST, activeID);
+            long       target = (POS - FIRST) + arg.value;
+            if ((POS == LAST || *POS != activeID) && arg.value > 0)
+                target--;
+
+            target = ((target % COUNT) + COUNT) % COUNT;
+
+            return *(FIRST + target);
+        }
+        case WSARG_EMPTY: return findEmptyWorkspace(occupancy.occupied, range.min, range.max).value_or(activeID);
+        case WSARG_PREVIOUS: return std::nullopt;
+    }
+
+    if (wsID > N)
+        wsID = ((wsID - 1) % N) + 1;
+
+    return range.min + wsID - 1;
+}
+
+void SWorkspaceHistory::push(long id) {
+    if (count > 0 && ids[(head + SIZE - 1) % SIZE] == id)
+        return;
+
+    ids[head] = id;
+    head      = (head + 1) % SIZE;
+    if (count < SIZE)
+        count++;
+}
+
+std::optional<long> SWorkspaceHistory::previous(long current, const MonitorRange& range) const {
+    for (size_t i = 1; i <= count; i++) {
+        const long ID = ids[(head + SIZE - i) % SIZE];
+        if (ID != current && range.contains(ID))
+            return ID;
+    }
+
+    return std::nullopt;
+}
+
+SRulePlan planPersistentRules(const std::vector<SPersistentRule>& existing, const std::vector<std::pair<MonitorRange, std::string>>& desired) {
+    SRulePlan                        plan;
+
+    std::unordered_map<long, size_t> existingByID; // workspace id -> index into existing
+    existingByID.reserve(existing.size());
+    for (size_t i = 0; i < existing.size(); i++) {
+        existingByID.emplace(existing[i].id, i);
+    }
+
+    std::vector<bool> wanted(existing.size(), false);
+
+    for (const auto& [RANGE, MONITOR] : desired) {
+        for (auto i = RANGE.min; i <= RANGE.max; i++) {
+            const auto IT = existingByID.find(i);
+            if (IT == existingByID.end()) {
+                plan.add.emplace_back(SPersistentRule{i, MONITOR});
+                continue;
+            }
+
+            wanted[IT->second] = true;
+            if (existing[IT->second].monitor != MONITOR)
+                plan.update.emplace_back(IT->second, MONITOR);
+        }
+    }
+
+    // rules for ids that no longer belong to any monitor, e.g. after num_workspaces shrinks
+    for (size_t i = 0; i < existing.size(); i++) {
+        if (!wanted[i])
+            plan.remove.push_back(i);
+    }
+
+    return plan;
+}
+
+std::optional<long> remapWorkspaceID(const SRangeRemap& remap, long id) {
+    const auto OLDBASE = baseForWorkspaceID(remap.oldLayout, id);
+    if (OLDBASE < 0 || (size_t)OLDBASE >= remap.newBaseByOldBase.size() || remap.newBaseByOldBase[OLDBASE] < 0)
+        return std::nullopt;
+
+    const auto NEWRANGE = rangeForBase(remap.newLayout, remap.newBaseByOldBase[OLDBASE]);
+    if (NEWRANGE.size() < 1)
+        return std::nullopt;
+
+    return NEWRANGE.min + std::min(id - rangeForBase(remap.oldLayout, OLDBASE).min, NEWRANGE.size() - 1);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+// workspace mapping logic that does not depend on hyprland, shared by the plugin and bench/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class MonitorRange {
+  public:
+    long base = -1;
+    long min; // min workspace id on monitor (inclusive)
+    long max; // max workspace id on monitor (inclusive)
+
+    MonitorRange(long base_, long numWorkspaces) : base(base_), min((base_ * numWorkspaces) + 1), max((base_ + 1) * numWorkspaces) {}
+    MonitorRange(long base_, long min_, long max_) : base(base_), min(min_), max(max_) {}
+
+    bool contains(const long& num) const {
+        return num >= min && num <= max;
+    }
+
+    long size() const {
+        return max - min + 1;
+    }
+};
+
+// where each base's range starts when monitors can have different workspace counts. bases past the table continue with
+// defaultCount each, so a monitor that isn't in the table yet still gets a stable range
+struct SRangeLayout {
+    long              defaultCount = 10;
+    std::vector<long> starts; // prefix sums, starts[b] is the last id before base b's range, one more entry than there are bases
+
+    bool              operator==(const SRangeLayout&) const = default;
+};
+
+// counts[b] is the number of workspaces of base b
+void         buildRangeLayout(SRangeLayout& layout, const std::vector<long>& counts, long defaultCount);
+MonitorRange rangeForBase(const SRangeLayout& layout, long base);
+// binary search over the prefix sums, -1 for ids below 1
+long         baseForWorkspaceID(const SRangeLayout& layout, long id);
+
+struct SMonitorDesc {
+    long        id       = -1;
+    std::string name;
+    bool        mirror   = false;
+    long        priority = -1; // index of the last monitor_priority selector matching this monitor, -1 if none
+    long        base     = -1; // filled in by assignMonitorBases
+};
+
+// see "How workspaces are assigned to monitors" in the README
+void assignMonitorBases(std::vector<SMonitorDesc>& monitors, bool priorityMode, size_t numPriorities);
+
+// sorted workspace id sets for one compositor
+struct SOccupancy {
+    std::vector<long> live;     // existing non special workspaces
+    std::vector<long> occupied; // workspaces with at least one mapped window
+};
+
+void                sortedInsert(std::vector<long>& v, long id);
+void                sortedErase(std::vector<long>& v, long id);
+
+// first workspace id in [min, max] without mapped windows
+std::optional<long> findEmptyWorkspace(const std::vector<long>& occupied, long min, long max);
+
+enum eWorkspaceArgKind : uint8_t {
+    WSARG_PASSTHROUGH = 0, // not handled by hyprsplit, passed to hyprland as is
+    WSARG_ABSOLUTE,        // 3
+    WSARG_RELATIVE,        // +1, no looping
+    WSARG_RELATIVE_WRAP,   // r+1
+    WSARG_RELATIVE_OPEN,   // e+1
+    WSARG_RELATIVE_LOOP,   // m+1
+    WSARG_EMPTY,           // empty
+    WSARG_PREVIOUS,        // previous, previous_per_monitor. resolved from the monitor's SWorkspaceHistory by the caller
+};
+
+// a workspace param parsed once, resolving it is plain integer arithmetic against the monitor range
+struct SWorkspaceArg {
+    eWorkspaceArgKind kind  = WSARG_PASSTHROUGH;
+    long              value = 0;
+};
+
+// transparent so args can be looked up by string_view without building a key
+struct SStringHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view str) const {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+using CWorkspaceArgCache = std::unordered_map<std::string, SWorkspaceArg, SStringHash, std::equal_to<>>;
+
+std::optional<long>  parseSignedNumber(std::string_view str);
+SWorkspaceArg        parseWorkspaceArg(std::string_view workspace);
+const SWorkspaceArg& getCachedWorkspaceArg(CWorkspaceArgCache& cache, std::string_view workspace);
+
+// nullopt if the arg should be passed to hyprland as is. numbers are local to the range, wrapping at its size
+std::optional<long> resolveWorkspaceArg(const SWorkspaceArg& arg, const MonitorRange& range, long activeID, const SOccupancy& occupancy);
+
+// the last workspaces a monitor showed, fixed size so recording a workspace change never allocates
+struct SWorkspaceHistory {
+    static constexpr size_t SIZE = 16;
+
+    std::array<long, SIZE>  ids   = {};
+    uint8_t                 head  = 0; // next write position
+    uint8_t                 count = 0;
+
+    void                    push(long id);
+    // the most recent workspace other than current that is still inside the range
+    std::optional<long>     previous(long current, const MonitorRange& range) const;
+};
+
+struct SPersistentRule {
+    long        id = 0;
+    std::string monitor;
+};
+
+struct SRulePlan {
+    std::vector<std::pair<size_t, std::string>> update; // index into existing -> new monitor
+    std::vector<SPersistentRule>                add;
+    std::vector<size_t>                         remove; // indices into existing, ascending
+};
+
+// diffs the existing hyprsplit persistent rules against the rules wanted for the given monitor ranges
+SRulePlan planPersistentRules(const std::vector<SPersistentRule>& existing, const std::vector<std::pair<MonitorRange, std::string>>& desired);
+
+struct SRangeRemap {
+    SRangeLayout      oldLayout;
+    SRangeLayout      newLayout;
+    std::vector<long> newBaseByOldBase; // -1 if the monitor that owned the old range is gone
+};
+
+// keeps a workspace's slot within its monitor's range across a workspace count change, slots past the new count collapse onto the
+// last one. nullopt if the id was not in any old range or its monitor has no new one
+std::optional<long> remapWorkspaceID(const SRangeRemap& remap, long id);
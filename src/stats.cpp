@@ -0,0 +1,77 @@
+#include "stats.hpp"
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <iterator>
+
+static constexpr std::array<const char*, STATS_COUNT> SECTIONNAMES = {
+    "split:workspace",
+    "split:movetoworkspace",
+    "split:movetoworkspacesilent",
+    "split:swapactiveworkspaces",
+    "split:rotateactiveworkspaces",
+    "split:swapmonitors",
+    "split:grabroguewindows",
+    "split:movewindows",
+    "ensureGoodWorkspaces",
+    "monitorAdded",
+    "monitorRemoved",
+    "hotplugSettled",
+    "configReloaded",
+    "workspaceSwipeBegin",
+    "split:<workspace>",
+};
+
+static std::array<SLatencyHistogram, STATS_COUNT> g_histograms;
+
+void SLatencyHistogram::record(uint64_t ns) {
+    // bucket n holds [2^(n+9), 2^(n+10)) ns, roughly 1us, 2us, 4us, ...
+    const size_t BUCKET = std::bit_width(ns >> 10);
+    buckets[std::min(BUCKET, BUCKETS - 1)]++;
+    count++;
+    totalNs += ns;
+    maxNs = std::max(maxNs, ns);
+}
+
+uint64_t SLatencyHistogram::bucketUpperBoundNs(size_t bucket) {
+    return 1ULL << (bucket + 10);
+}
+
+const char* statsSectionName(eStatsSection section) {
+    return SECTIONNAMES[section];
+}
+
+void statsRecord(eStatsSection section, uint64_t ns) {
+    g_histograms[section].record(ns);
+}
+
+void statsReset() {
+    g_histograms = {};
+}
+
+std::string statsToJSON() {
+    std::string result = "{";
+    auto        out    = std::back_inserter(result);
+
+    for (size_t i = 0; i < STATS_COUNT; i++) {
+        const auto& H = g_histograms[i];
+
+        std::format_to(out, "{}\"{}\": {{\"count\": {}, \"totalNs\": {}, \"meanNs\": {}, \"maxNs\": {}, \"buckets\": [", i == 0 ? "" : ", ", SECTIONNAMES[i], H.count, H.totalNs,
+                       H.count ? H.totalNs / H.count : 0, H.maxNs);
+
+        // only non empty buckets, as [upper bound ns, count]
+        bool first = true;
+        for (size_t b = 0; b < SLatencyHistogram::BUCKETS; b++) {
+            if (!H.buckets[b])
+                continue;
+
+            std::format_to(out, "{}[{}, {}]", first ? "" : ", ", b == SLatencyHistogram::BUCKETS - 1 ? UINT64_MAX : SLatencyHistogram::bucketUpperBoundNs(b), H.buckets[b]);
+            first = false;
+        }
+
+        result += "]}";
+    }
+
+    result += "}";
+    return result;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+// per dispatcher / event handler latency histograms, exposed through `hyprctl hyprsplit stats`
+
+#include "trace.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum eStatsSection : uint8_t {
+    STATS_WORKSPACE = 0,
+    STATS_MOVETOWORKSPACE,
+    STATS_MOVETOWORKSPACESILENT,
+    STATS_SWAPACTIVEWORKSPACES,
+    STATS_ROTATEACTIVEWORKSPACES,
+    STATS_SWAPMONITORS,
+    STATS_GRABROGUEWINDOWS,
+    STATS_MOVEWINDOWS,
+    STATS_ENSUREGOODWORKSPACES,
+    STATS_MONITORADDED,
+    STATS_MONITORREMOVED,
+    STATS_HOTPLUGSETTLED,
+    STATS_CONFIGRELOADED,
+    STATS_SWIPEBEGIN,
+    STATS_LOCALWORKSPACE,
+    STATS_COUNT,
+};
+
+// log2 buckets, bucket 0 is everything below ~1us and the last bucket everything above ~4s
+struct SLatencyHistogram {
+    static constexpr size_t       BUCKETS = 24;
+
+    std::array<uint64_t, BUCKETS> buckets = {};
+    uint64_t                      count   = 0;
+    uint64_t                      totalNs = 0;
+    uint64_t                      maxNs   = 0;
+
+    void                          record(uint64_t ns);
+    static uint64_t               bucketUpperBoundNs(size_t bucket);
+};
+
+const char* statsSectionName(eStatsSection section);
+void        statsRecord(eStatsSection section, uint64_t ns);
+void        statsReset();
+std::string statsToJSON();
+
+// records the time between construction and destruction into a section, and into the trace while it is on
+class CStatsTimer {
+  public:
+    CStatsTimer(eStatsSection section) : m_section(section), m_begin(std::chrono::steady_clock::now()) {}
+
+    ~CStatsTimer() {
+        const auto END = std::chrono::steady_clock::now();
+        statsRecord(m_section, std::chrono::duration_cast<std::chrono::nanoseconds>(END - m_begin).count());
+
+        // every stats section is also a trace span
+        if (g_traceEnabled)
+            traceRecord(statsSectionName(m_section), m_begin, END);
+    }
+
+    CStatsTimer(const CStatsTimer&)            = delete;
+    CStatsTimer& operator=(const CStatsTimer&) = delete;
+
+  private:
+    eStatsSection                         m_section;
+    std::chrono::steady_clock::time_point m_begin;
+};
@@ -0,0 +1,73 @@
+#include "trace.hpp"
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <vector>
+
+static constexpr size_t         TRACECAPACITY = 1 << 16;
+
+static std::vector<STraceEvent> g_traceEvents; // allocated on start, the oldest events are overwritten once full
+static size_t                   g_traceNext    = 0;
+static bool                     g_traceWrapped = false;
+
+void traceStart() {
+    g_traceEvents.assign(TRACECAPACITY, {});
+    g_traceNext    = 0;
+    g_traceWrapped = false;
+    g_traceEnabled = true;
+}
+
+void traceStop() {
+    g_traceEnabled = false;
+}
+
+size_t traceSize() {
+    return g_traceWrapped ? g_traceEvents.size() : g_traceNext;
+}
+
+void traceRecord(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, const char* argName, int64_t arg) {
+    if (g_traceEvents.empty())
+        return;
+
+    g_traceEvents[g_traceNext] = {
+        .name    = name,
+        .beginNs = std::chrono::duration_cast<std::chrono::nanoseconds>(begin.time_since_epoch()).count(),
+        .durNs   = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(),
+        .argName = argName,
+        .arg     = arg,
+    };
+
+    if (++g_traceNext == g_traceEvents.size()) {
+        g_traceNext    = 0;
+        g_traceWrapped = true;
+    }
+}
+
+std::string traceDump(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.good())
+        return std::format("failed to open {}", path);
+
+    const auto  PID = getpid();
+    std::string out = "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    auto        it  = std::back_inserter(out);
+
+    // oldest first
+    const size_t COUNT = traceSize();
+    const size_t FIRST = g_traceWrapped ? g_traceNext : 0;
+    for (size_t i = 0; i < COUNT; i++) {
+        const auto& E = g_traceEvents[(FIRST + i) % g_traceEvents.size()];
+
+        std::format_to(it, "{}{{\"name\": \"{}\", \"cat\": \"hyprsplit\", \"ph\": \"X\", \"ts\": {:.3f}, \"dur\": {:.3f}, \"pid\": {}, \"tid\": {}", i == 0 ? "" : ", ", E.name,
+                       E.beginNs / 1000.0, E.durNs / 1000.0, PID, PID);
+        if (E.argName)
+            std::format_to(it, ", \"args\": {{\"{}\": {}}}", E.argName, E.arg);
+        out += '}';
+    }
+
+    out += "]}";
+    file << out;
+
+    return file.good() ? "" : std::format("failed to write {}", path);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// ring buffered chrome trace event recorder, off by default, toggled with `hyprctl hyprsplit trace`.
+// the dump loads in perfetto / chrome://tracing next to compositor traces, timestamps are CLOCK_MONOTONIC
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+inline bool g_traceEnabled = false;
+
+// name and argName must be string literals, nothing is copied while recording
+struct STraceEvent {
+    const char* name    = nullptr;
+    int64_t     beginNs = 0;
+    int64_t     durNs   = 0;
+    const char* argName = nullptr;
+    int64_t     arg     = 0;
+};
+
+void        traceStart();
+void        traceStop();
+size_t      traceSize();
+void        traceRecord(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, const char* argName = nullptr,
+                        int64_t arg = 0);
+// empty on success, an error otherwise
+std::string traceDump(const std::string& path);
+
+// records a complete event from construction to destruction while tracing is on
+class CTraceSpan {
+  public:
+    CTraceSpan(const char* name, const char* argName = nullptr, int64_t arg = 0) : m_name(name), m_argName(argName), m_arg(arg) {
+        if (g_traceEnabled)
+            m_begin = std::chrono::steady_clock::now();
+    }
+
+    ~CTraceSpan() {
+        if (g_traceEnabled && m_begin != std::chrono::steady_clock::time_point{})
+            traceRecord(m_name, m_begin, std::chrono::steady_clock::now(), m_argName, m_arg);
+    }
+
+    CTraceSpan(const CTraceSpan&)            = delete;
+    CTraceSpan& operator=(const CTraceSpan&) = delete;
+
+  private:
+    const char*                           m_name;
+    const char*                           m_argName;
+    int64_t                               m_arg;
+    std::chrono::steady_clock::time_point m_begin;
+};